@@ -0,0 +1,329 @@
+/*
+========================================
+ CALIBRATE: velocidad de caída por cantidad de opciones
+========================================
+
+Simula muchos jugadores (Monte Carlo) atrapando letras con la misma geometría
+y física que el juego (fallmodel.h) y, para cada cantidad de opciones, elige
+la velocidad inicial y la aceleración que dejan la probabilidad de atrapar la
+letra buscada en el objetivo. Escribe la tabla que el juego carga al iniciar
+(quiz.speeds).
+
+Modelo de jugador (por intento):
+  - Ya sabe la respuesta: apunta a una letra al azar (la correcta puede ser
+    cualquiera) desde una posición de paleta al azar.
+  - Reacciona después de un tiempo con distribución lognormal.
+  - Para 1 o 2 pasos toca la tecla; para más la mantiene apretada y avanza con
+    la repetición de teclado (demora inicial y frecuencia).
+  - Suelta la tecla con un error de tiempo normal: puede pasarse o quedarse
+    corto algún paso.
+
+Se prueban todas las combinaciones de la grilla en paralelo (un hilo por
+núcleo). Cada combinación usa su propia semilla, así el resultado no depende
+de la cantidad de hilos. De las que alcanzan el objetivo se queda con la de
+caída más corta (la más difícil); si ninguna llega, con la más fácil.
+
+Compilar (escritorio, no necesita SDL):
+
+g++ calibrate.cpp -o calibrate -std=c++11 -O2 -pthread
+
+Uso:
+
+calibrate [-o quiz.speeds] [-j hilos] [--target 0.85] [--trials N] [--choices 2-6]
+          [--rt-ms 600] [--rt-sigma 0.3] [--repeat-delay 500] [--repeat-rate 30]
+          [--tap-ms 150] [--release-sigma 50] [--seed N]
+
+Los tiempos van en milisegundos; la repetición de teclado en teclas por segundo.
+
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fallmodel.h"
+
+using namespace std;
+
+static const double FRAME_MS = 1000.0 / 60.0; // el navegador dibuja a ~60 fps
+static const int MAX_FRAMES = 60 * 60;
+
+// Grilla de búsqueda. La caída avanza (int)velocidad píxeles por frame, así que
+// las velocidades fraccionarias solo se notan cuando acelera.
+static const float SPEED_MIN = 1.0f;
+static const float SPEED_MAX = 8.0f;
+static const float SPEED_STEP = 0.5f;
+static const float ACCEL_MIN = 0.0f;
+static const float ACCEL_MAX = 0.02f;
+static const float ACCEL_STEP = 0.0025f;
+
+struct PlayerModel {
+    double rtMedianMs = 600;
+    double rtSigma = 0.3;
+    double repeatDelayMs = 500;
+    double repeatRate = 30;
+    double tapMs = 150;
+    double releaseSigmaMs = 50;
+};
+
+// Trayectoria de la caída, igual para todos los jugadores: frames en los que
+// las letras están a la altura de la paleta (ahí se decide la colisión).
+struct Trajectory {
+    int firstFrame = -1;
+    int lastFrame = -1;
+};
+
+struct Task {
+    int choices = 0;
+    FallSpeed speed;
+};
+
+struct Result {
+    double prob = 0.0;
+    double fallMs = 0.0; // tiempo hasta que las letras llegan a la paleta
+    bool reachable = false;
+};
+
+// Misma secuencia que updateGame(): avanza, prueba la colisión y después acelera.
+static Trajectory trajectory(FallSpeed s) {
+    Trajectory t;
+    int y = LETTER_TOP_Y;
+    float v = s.initial;
+    for (int f = 1; f <= MAX_FRAMES && y <= H; f++) {
+        y += (int)v;
+        bool inBand = (y < PADDLE_Y + PADDLE_HEIGHT) && (y + LETTER_SIZE > PADDLE_Y);
+        if (inBand) {
+            if (t.firstFrame < 0) t.firstFrame = f;
+            t.lastFrame = f;
+        } else if (t.firstFrame >= 0) {
+            break;
+        }
+        v += s.accel;
+    }
+    return t;
+}
+
+// Posiciones a las que llega la paleta desde el centro, en orden.
+static vector<int> paddlePositions() {
+    int x = W / 2 - PADDLE_WIDTH / 2;
+    while (paddleStepX(x, -1) != x) x = paddleStepX(x, -1);
+    vector<int> out{x};
+    while (paddleStepX(x, 1) != x) {
+        x = paddleStepX(x, 1);
+        out.push_back(x);
+    }
+    return out;
+}
+
+static uint64_t splitmix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Probabilidad de atrapar la letra buscada con una configuración de caída.
+static Result simulate(const Task& task, const PlayerModel& pm, const vector<int>& positions, int trials, uint64_t seed) {
+    Result res;
+    Trajectory traj = trajectory(task.speed);
+    if (traj.firstFrame < 0) return res;
+    res.reachable = true;
+    res.fallMs = traj.firstFrame * FRAME_MS;
+
+    const int n = task.choices;
+    vector<int> letters(n);
+    for (int i = 0; i < n; i++) letters[i] = letterX(i, n);
+
+    mt19937_64 rng(seed);
+    lognormal_distribution<double> reaction(log(pm.rtMedianMs), pm.rtSigma);
+    normal_distribution<double> release(0.0, pm.releaseSigmaMs);
+    uniform_int_distribution<int> pickLetter(0, n - 1);
+    uniform_int_distribution<int> pickStart(0, (int)positions.size() - 1);
+    const double repeatMs = 1000.0 / pm.repeatRate;
+
+    int hits = 0;
+    for (int trial = 0; trial < trials; trial++) {
+        int target = pickLetter(rng);
+        int startIdx = pickStart(rng);
+
+        // Paso al que apunta: paleta centrada sobre la letra.
+        int want = letters[target] + LETTER_SIZE / 2 - PADDLE_WIDTH / 2;
+        int bestIdx = startIdx;
+        for (int i = 0; i < (int)positions.size(); i++) {
+            if (abs(positions[i] - want) < abs(positions[bestIdx] - want)) bestIdx = i;
+        }
+        int steps = abs(bestIdx - startIdx);
+        int dir = (bestIdx > startIdx) ? 1 : -1;
+
+        // Momento de cada paso, desde que empiezan a caer las letras.
+        double rt = reaction(rng);
+        bool hold = steps > 2;
+        auto stepTime = [&](int k) {
+            if (!hold) return rt + k * pm.tapMs;
+            return (k == 0) ? rt : rt + pm.repeatDelayMs + (k - 1) * repeatMs;
+        };
+        int taken = steps;
+        if (hold) {
+            double releaseAt = stepTime(steps - 1) + repeatMs / 2 + release(rng);
+            taken = 0;
+            while (taken < (int)positions.size() && stepTime(taken) <= releaseAt) taken++;
+        }
+
+        // En cada frame a la altura de la paleta gana la primera letra que se toca.
+        int caught = -1;
+        for (int f = traj.firstFrame; f <= traj.lastFrame && caught < 0; f++) {
+            double now = f * FRAME_MS;
+            int done = 0;
+            while (done < taken && stepTime(done) <= now) done++;
+            int idx = max(0, min((int)positions.size() - 1, startIdx + dir * done));
+            int px = positions[idx];
+            for (int i = 0; i < n; i++) {
+                if (letters[i] < px + PADDLE_WIDTH && letters[i] + LETTER_SIZE > px) {
+                    caught = i;
+                    break;
+                }
+            }
+        }
+        if (caught == target) hits++;
+    }
+    res.prob = (double)hits / trials;
+    return res;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Uso: %s [-o quiz.speeds] [-j hilos] [--target P] [--trials N] [--choices A-B]\n"
+            "       [--rt-ms MS] [--rt-sigma S] [--repeat-delay MS] [--repeat-rate HZ]\n"
+            "       [--tap-ms MS] [--release-sigma MS] [--seed N]\n",
+            prog);
+}
+
+int main(int argc, char* argv[]) {
+    string outPath = SPEED_TABLE_PATH;
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    double target = 0.85;
+    int trials = 20000;
+    int minChoices = 2, maxChoices = 6;
+    uint64_t seed = 1;
+    PlayerModel pm;
+
+    for (int i = 1; i < argc; i++) {
+        string a = argv[i];
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 2;
+        }
+        const char* v = argv[++i];
+        if (a == "-o") outPath = v;
+        else if (a == "-j") threads = (unsigned)max(1, atoi(v));
+        else if (a == "--target") target = atof(v);
+        else if (a == "--trials") trials = max(1, atoi(v));
+        else if (a == "--choices") {
+            if (sscanf(v, "%d-%d", &minChoices, &maxChoices) == 1) maxChoices = minChoices;
+        }
+        else if (a == "--rt-ms") pm.rtMedianMs = atof(v);
+        else if (a == "--rt-sigma") pm.rtSigma = atof(v);
+        else if (a == "--repeat-delay") pm.repeatDelayMs = atof(v);
+        else if (a == "--repeat-rate") pm.repeatRate = atof(v);
+        else if (a == "--tap-ms") pm.tapMs = atof(v);
+        else if (a == "--release-sigma") pm.releaseSigmaMs = atof(v);
+        else if (a == "--seed") seed = strtoull(v, nullptr, 10);
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (minChoices < 1 || maxChoices > SPEED_TABLE_MAX_CHOICES || minChoices > maxChoices ||
+        target <= 0 || target >= 1 || pm.repeatRate <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // Una tarea por combinación; la primera de cada cantidad de opciones es la
+    // configuración actual del juego, como referencia.
+    vector<Task> tasks;
+    for (int n = minChoices; n <= maxChoices; n++) {
+        Task current;
+        current.choices = n;
+        tasks.push_back(current);
+        for (float s = SPEED_MIN; s <= SPEED_MAX + 1e-4f; s += SPEED_STEP) {
+            for (float a = ACCEL_MIN; a <= ACCEL_MAX + 1e-6f; a += ACCEL_STEP) {
+                Task t;
+                t.choices = n;
+                t.speed.initial = s;
+                t.speed.accel = a;
+                tasks.push_back(t);
+            }
+        }
+    }
+
+    const vector<int> positions = paddlePositions();
+    vector<Result> results(tasks.size());
+    atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < tasks.size(); i = next++) {
+            results[i] = simulate(tasks[i], pm, positions, trials, splitmix(seed ^ splitmix(i)));
+        }
+    };
+
+    threads = min<unsigned>(threads, (unsigned)tasks.size());
+    printf("%zu combinaciones x %d jugadores en %u hilos...\n", tasks.size(), trials, threads);
+    vector<thread> pool;
+    for (unsigned t = 0; t < threads; t++) pool.emplace_back(worker);
+    for (auto& t : pool) t.join();
+
+    FILE* out = fopen(outPath.c_str(), "w");
+    if (!out) {
+        fprintf(stderr, "No se pudo crear %s\n", outPath.c_str());
+        return 1;
+    }
+    fprintf(out, "# Velocidad de caida por cantidad de opciones: generado por calibrate\n");
+    fprintf(out, "# objetivo %.2f, %d jugadores por combinacion\n", target, trials);
+    fprintf(out, "# jugador: reaccion %.0f ms (sigma %.2f), repeticion %.0f ms + %.0f/s, toque %.0f ms, error al soltar %.0f ms\n",
+            pm.rtMedianMs, pm.rtSigma, pm.repeatDelayMs, pm.repeatRate, pm.tapMs, pm.releaseSigmaMs);
+    fprintf(out, "# opciones velocidad aceleracion prob caida_ms\n");
+
+    printf("\nopciones | actual (%d, %.4f)     | calibrada\n", INITIAL_SPEED, SPEED_ACCEL);
+    size_t i = 0;
+    while (i < tasks.size()) {
+        int n = tasks[i].choices;
+        const Result& current = results[i];
+        size_t best = 0;
+        bool bestMeets = false;
+        for (size_t j = i + 1; j < tasks.size() && tasks[j].choices == n; j++) {
+            const Result& r = results[j];
+            if (!r.reachable) continue;
+            bool meets = r.prob >= target;
+            const Result* b = best ? &results[best] : nullptr;
+            bool better;
+            if (!b) better = true;
+            else if (meets != bestMeets) better = meets;
+            else if (meets) better = r.fallMs < b->fallMs || (r.fallMs == b->fallMs && r.prob > b->prob);
+            else better = r.prob > b->prob;
+            if (better) {
+                best = j;
+                bestMeets = meets;
+            }
+        }
+        if (best) {
+            const Task& t = tasks[best];
+            const Result& r = results[best];
+            fprintf(out, "%d %.2f %.4f %.3f %.0f\n", n, t.speed.initial, t.speed.accel, r.prob, r.fallMs);
+            printf("%8d | p=%.3f caida %5.0f ms | %.2f %.4f p=%.3f caida %5.0f ms%s\n",
+                   n, current.prob, current.fallMs, t.speed.initial, t.speed.accel, r.prob, r.fallMs,
+                   bestMeets ? "" : "  (no alcanza el objetivo)");
+        }
+        while (i < tasks.size() && tasks[i].choices == n) i++;
+    }
+    fclose(out);
+    printf("\nTabla escrita en %s\n", outPath.c_str());
+    return 0;
+}
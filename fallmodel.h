@@ -0,0 +1,59 @@
+/*
+========================================
+ MODELO DE LA CAÍDA DE LETRAS
+========================================
+
+Geometría y física de la caída, compartidas por quizcatch.cpp y por la
+herramienta de calibración calibrate.cpp: si algo cambia acá, la simulación
+sigue al juego sin tocarla.
+
+Tabla de velocidades (quiz.speeds, texto, la escribe calibrate.cpp):
+  - Las líneas que empiezan con '#' son comentarios.
+  - Cada línea: opciones velocidad_inicial aceleracion [prob] [caida_ms]
+    Las dos últimas columnas son informativas; el juego no las usa.
+  - Para una cantidad de opciones que no está en la tabla (o sin tabla)
+    se usan INITIAL_SPEED y SPEED_ACCEL.
+*/
+
+#ifndef QUIZ_FALLMODEL_H
+#define QUIZ_FALLMODEL_H
+
+static const int W = 800;
+static const int H = 600;
+
+static const int PADDLE_WIDTH = 140;
+static const int PADDLE_HEIGHT = 12;
+static const int PADDLE_Y = H - 40;
+static const int PADDLE_STEP = 12; // píxeles por tecla o por clic en las flechas
+
+static const int LETTER_SIZE = 28;
+static const int LETTER_TOP_Y = 150; // altura donde aparecen las letras
+static const int LETTER_PAD = 40;    // margen izquierdo y derecho de la fila de letras
+static const int INITIAL_SPEED = 2;      // <- antes 5 (más lento al inicio)
+static const float SPEED_ACCEL = 0.005f; // <- antes 0.01f (acelera más suave)
+
+static const char* const SPEED_TABLE_PATH = "quiz.speeds";
+static const int SPEED_TABLE_MAX_CHOICES = 16;
+
+// Velocidad de caída (píxeles por frame) y aceleración por frame.
+struct FallSpeed {
+    float initial = (float)INITIAL_SPEED;
+    float accel = SPEED_ACCEL;
+};
+
+// x de la letra i de n: repartidas de borde a borde entre los márgenes.
+static inline int letterX(int i, int n) {
+    const int usable = W - 2 * LETTER_PAD;
+    float t = (n == 1) ? 0.5f : (float)i / (float)(n - 1);
+    return LETTER_PAD + (int)(t * usable) - LETTER_SIZE / 2;
+}
+
+// x de la paleta después de un paso a la izquierda (dir < 0) o derecha (dir > 0).
+// En el borde no se mueve.
+static inline int paddleStepX(int x, int dir) {
+    if (dir < 0 && x > 0) return x - PADDLE_STEP;
+    if (dir > 0 && x < W - PADDLE_WIDTH) return x + PADDLE_STEP;
+    return x;
+}
+
+#endif
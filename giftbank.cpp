@@ -0,0 +1,556 @@
+/*
+========================================
+ GIFTBANK: une muchos .gift en un solo banco
+========================================
+
+Recorre archivos, directorios (recursivo, *.gift) y patrones con comodines,
+los parsea en paralelo con las mismas reglas que parseGiftSimple (quizcatch.cpp),
+descarta preguntas repetidas (hash del contenido) y escribe:
+
+  - un banco único listo para el juego (-o, por defecto banco.gift)
+  - un reporte con cada pregunta descartada o sospechosa, con archivo y línea
+    (-r, por defecto banco.report.txt)
+
+Los archivos grandes se parten en bloques de ~chunk MB. Los cortes caen
+siempre en un salto de línea posterior a un '}', así ningún bloque parte una
+pregunta y cada hilo parsea su bloque sin coordinarse con los demás.
+
+Compilar (escritorio, no necesita SDL):
+
+g++ giftbank.cpp -o giftbank -std=c++17 -O2 -pthread
+
+Uso:
+
+giftbank [-o banco.gift] [-r reporte.txt] [-j hilos] [--chunk MB] entradas...
+
+Ejemplos:
+
+giftbank -o quiz.gift cursos/
+giftbank -o quiz.gift "cursos/tema?.gift" extra/
+
+Comodines: '*' y '?' no cruzan '/', '**' cruza directorios.
+
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Un problema encontrado en una pregunta. 'line' es relativa al bloque hasta la unión.
+struct Issue {
+    uint64_t line = 0;
+    bool dropped = false;
+    string msg;
+};
+
+struct ParsedQuestion {
+    uint64_t hash = 0;
+    uint64_t line = 0;
+    string gift; // pregunta ya formateada para el banco de salida
+};
+
+struct Task {
+    size_t file = 0;
+    uint64_t begin = 0; // rango nominal; los bordes reales los fija findBoundary
+    uint64_t end = 0;
+};
+
+struct ChunkResult {
+    uint64_t bytes = 0;
+    uint64_t newlines = 0;
+    size_t found = 0; // bloques '{...}' encontrados
+    vector<ParsedQuestion> qs;
+    vector<Issue> issues;
+};
+
+struct InputFile {
+    string path;
+    uint64_t size = 0;
+};
+
+// Elimina espacios en blanco al inicio y final de una cadena.
+static string trim(const string& s) {
+    size_t a = 0;
+    while (a < s.size() && isspace(static_cast<unsigned char>(s[a]))) a++;
+    size_t b = s.size();
+    while (b > a && isspace(static_cast<unsigned char>(s[b - 1]))) b--;
+    return s.substr(a, b - a);
+}
+
+// Colapsa espacios para que el hash no dependa del formato.
+static string normalizeSpaces(const string& s) {
+    string out;
+    bool space = false;
+    for (unsigned char c : s) {
+        if (isspace(c)) {
+            space = true;
+            continue;
+        }
+        if (space && !out.empty()) out.push_back(' ');
+        space = false;
+        out.push_back((char)c);
+    }
+    return out;
+}
+
+// Hash FNV-1a de 64 bits.
+static uint64_t fnv1a(const string& s, uint64_t h = 1469598103934665603ULL) {
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// Compara con comodines: '*' y '?' no cruzan '/', "**" cruza directorios.
+static bool wildMatch(const char* p, const char* s) {
+    if (*p == '\0') return *s == '\0';
+    if (p[0] == '*' && p[1] == '*') {
+        const char* rest = p + 2;
+        if (*rest == '/') rest++;
+        for (const char* t = s;; t++) {
+            if (wildMatch(rest, t)) return true;
+            if (*t == '\0') return false;
+        }
+    }
+    if (*p == '*') {
+        for (const char* t = s;; t++) {
+            if (wildMatch(p + 1, t)) return true;
+            if (*t == '\0' || *t == '/') return false;
+        }
+    }
+    if (*s == '\0') return false;
+    if (*p == '?') return *s != '/' && wildMatch(p + 1, s + 1);
+    return *p == *s && wildMatch(p + 1, s + 1);
+}
+
+static bool isGiftFile(const fs::path& p) {
+    string ext = p.extension().string();
+    transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)tolower(c); });
+    return ext == ".gift";
+}
+
+// Expande una entrada (archivo, directorio o patrón) a una lista ordenada de archivos.
+static vector<string> expandInput(const string& input) {
+    vector<string> out;
+    error_code ec;
+    string pattern = fs::path(input).generic_string();
+
+    if (pattern.find_first_of("*?") == string::npos) {
+        if (fs::is_directory(input, ec)) {
+            for (fs::recursive_directory_iterator it(input, ec), end; !ec && it != end; it.increment(ec)) {
+                if (it->is_regular_file(ec) && isGiftFile(it->path())) out.push_back(it->path().string());
+            }
+        } else if (fs::is_regular_file(input, ec)) {
+            out.push_back(input);
+        } else {
+            cerr << "No existe: " << input << endl;
+        }
+        sort(out.begin(), out.end());
+        return out;
+    }
+
+    // Base: la parte del patrón anterior al primer componente con comodines.
+    size_t wild = pattern.find_first_of("*?");
+    size_t slash = pattern.rfind('/', wild);
+    string base = (slash == string::npos) ? "." : pattern.substr(0, slash == 0 ? 1 : slash);
+    string rest = (slash == string::npos) ? pattern : pattern.substr(slash + 1);
+
+    for (fs::recursive_directory_iterator it(base, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+        string rel = it->path().lexically_relative(base).generic_string();
+        if (wildMatch(rest.c_str(), rel.c_str())) out.push_back(it->path().string());
+    }
+    if (out.empty()) cerr << "Sin coincidencias: " << input << endl;
+    sort(out.begin(), out.end());
+    return out;
+}
+
+// Devuelve el primer borde de bloque en o después de 'from': la posición
+// siguiente a un '\n' que está después de un '}' sin un '{' en el medio.
+static uint64_t findBoundary(ifstream& in, uint64_t from, uint64_t size) {
+    if (from == 0 || from >= size) return min(from, size);
+
+    static const size_t BLOCK = 64 * 1024;
+    vector<char> buf(BLOCK);
+    bool afterClose = false;
+    uint64_t pos = from;
+
+    in.clear();
+    in.seekg((streamoff)from);
+    while (pos < size) {
+        in.read(buf.data(), (streamsize)min<uint64_t>(BLOCK, size - pos));
+        size_t n = (size_t)in.gcount();
+        if (n == 0) break;
+        for (size_t i = 0; i < n; i++) {
+            char c = buf[i];
+            if (c == '}') afterClose = true;
+            else if (c == '{') afterClose = false;
+            else if (c == '\n' && afterClose) return pos + i + 1;
+        }
+        pos += n;
+    }
+    return size;
+}
+
+// Parsea un bloque con las reglas de parseGiftSimple y anota cada problema.
+static void parseChunk(const string& raw, ChunkResult& res) {
+    string s = raw;
+    s.erase(remove(s.begin(), s.end(), '\r'), s.end());
+
+    // Línea (relativa al bloque) de una posición; las consultas van en orden creciente.
+    size_t linePos = 0;
+    uint64_t lineNo = 0;
+    auto lineOf = [&](size_t p) {
+        for (; linePos < p; linePos++) {
+            if (s[linePos] == '\n') lineNo++;
+        }
+        return lineNo;
+    };
+
+    size_t pos = 0;
+    while (true) {
+        size_t open = s.find('{', pos);
+        if (open == string::npos) break;
+        res.found++;
+        uint64_t line = lineOf(open);
+
+        size_t close = s.find('}', open);
+        if (close == string::npos) {
+            res.issues.push_back({line, true, "'{' sin '}' de cierre: el juego ignora el resto del archivo"});
+            break;
+        }
+
+        size_t promptStart = s.rfind("\n", open);
+        if (promptStart == string::npos) promptStart = 0; else promptStart += 1;
+
+        size_t titleStart = s.rfind("::", open);
+        if (titleStart != string::npos && titleStart >= promptStart) {
+            size_t titleEnd = s.find("::", titleStart + 2);
+            if (titleEnd != string::npos && titleEnd < open) {
+                promptStart = titleEnd + 2;
+            }
+        }
+
+        string prompt = trim(s.substr(promptStart, open - promptStart));
+        string body = trim(s.substr(open + 1, close - (open + 1)));
+
+        vector<string> warnings;
+        vector<string> errors;
+
+        vector<pair<bool, string>> parsed;
+        {
+            bool curIsCorrect = false;
+            bool sawMarker = false;
+            string cur;
+
+            auto flush = [&]() {
+                string t = trim(cur);
+                if (!t.empty()) {
+                    if (!sawMarker) warnings.push_back("texto antes del primer '=' o '~' tomado como opcion incorrecta");
+                    parsed.push_back({curIsCorrect, t});
+                } else if (sawMarker) {
+                    warnings.push_back("opcion vacia ignorada");
+                }
+                cur.clear();
+            };
+
+            for (size_t i = 0; i < body.size(); i++) {
+                char c = body[i];
+                if (c == '=' || c == '~') {
+                    if (sawMarker || !trim(cur).empty()) flush();
+                    sawMarker = true;
+                    curIsCorrect = (c == '=');
+                } else {
+                    cur.push_back(c);
+                }
+            }
+            flush();
+        }
+
+        if (parsed.size() > 26) {
+            warnings.push_back(to_string(parsed.size()) + " opciones: el juego solo usa las primeras 26 (A-Z)");
+        }
+        size_t used = min<size_t>(parsed.size(), 26);
+
+        size_t correct = 0;
+        for (size_t i = 0; i < used; i++) {
+            if (parsed[i].first) correct++;
+        }
+
+        if (prompt.empty()) errors.push_back("enunciado vacio");
+        if (used < 2) errors.push_back("menos de 2 opciones");
+        if (correct == 0) {
+            bool later = any_of(parsed.begin() + used, parsed.end(),
+                                [](const pair<bool, string>& p) { return p.first; });
+            errors.push_back(later ? "la respuesta correcta queda despues de la opcion Z"
+                                   : "sin respuesta correcta ('=')");
+        }
+        if (correct > 1) warnings.push_back(to_string(correct) + " respuestas correctas");
+
+        {
+            set<string> seen;
+            for (size_t i = 0; i < used; i++) {
+                if (!seen.insert(normalizeSpaces(parsed[i].second)).second) {
+                    warnings.push_back("opcion repetida: " + parsed[i].second.substr(0, 40));
+                    break;
+                }
+            }
+        }
+
+        if (body.find_first_of("#%\\") != string::npos || body.find("->") != string::npos) {
+            warnings.push_back("sintaxis GIFT no soportada por el juego (#, %, ->, \\)");
+        }
+        if (body.find('{') != string::npos) warnings.push_back("'{' dentro de las opciones");
+
+        for (const auto& w : warnings) res.issues.push_back({line, false, w});
+
+        if (!errors.empty()) {
+            string msg;
+            for (const auto& e : errors) msg += (msg.empty() ? "" : "; ") + e;
+            res.issues.push_back({line, true, msg});
+        } else {
+            // Hash del contenido: sin título "::...::" y sin diferencias de espacios.
+            string bare = prompt;
+            if (bare.compare(0, 2, "::") == 0) {
+                size_t end = bare.find("::", 2);
+                if (end != string::npos) bare = trim(bare.substr(end + 2));
+            }
+            uint64_t h = fnv1a(normalizeSpaces(bare));
+
+            string gift = prompt + " {\n";
+            for (size_t i = 0; i < used; i++) {
+                h = fnv1a(parsed[i].first ? "\n=" : "\n~", h);
+                h = fnv1a(normalizeSpaces(parsed[i].second), h);
+                gift += (parsed[i].first ? "=" : "~") + parsed[i].second + "\n";
+            }
+            gift += "}\n\n";
+            res.qs.push_back({h, line, move(gift)});
+        }
+
+        pos = close + 1;
+    }
+
+    res.newlines = lineOf(s.size());
+}
+
+// Lee y parsea un bloque de un archivo entre bordes de pregunta.
+static void runTask(const Task& t, const vector<InputFile>& files, ChunkResult& res) {
+    const InputFile& f = files[t.file];
+    ifstream in(f.path, ios::binary);
+    if (!in) {
+        res.issues.push_back({0, true, "no se pudo abrir el archivo"});
+        return;
+    }
+
+    uint64_t begin = findBoundary(in, t.begin, f.size);
+    uint64_t end = findBoundary(in, t.end, f.size);
+    if (end <= begin) return;
+
+    string raw((size_t)(end - begin), '\0');
+    in.clear();
+    in.seekg((streamoff)begin);
+    in.read(&raw[0], (streamsize)raw.size());
+    raw.resize((size_t)in.gcount());
+    res.bytes = raw.size();
+    parseChunk(raw, res);
+}
+
+static void usage(const char* prog) {
+    cerr << "Uso: " << prog << " [-o banco.gift] [-r reporte.txt] [-j hilos] [--chunk MB] entradas..." << endl;
+}
+
+int main(int argc, char* argv[]) {
+    string outPath = "banco.gift";
+    string reportPath = "banco.report.txt";
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    uint64_t chunkBytes = 8ull << 20;
+    vector<string> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        string a = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (a == "-o" && hasValue) outPath = argv[++i];
+        else if (a == "-r" && hasValue) reportPath = argv[++i];
+        else if (a == "-j" && hasValue) threads = (unsigned)max(1, atoi(argv[++i]));
+        else if (a == "--chunk" && hasValue) chunkBytes = (uint64_t)max(1, atoi(argv[++i])) << 20;
+        else if (a == "-h" || a == "--help" || a[0] == '-') {
+            usage(argv[0]);
+            return 1;
+        } else inputs.push_back(a);
+    }
+    if (inputs.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    auto t0 = chrono::steady_clock::now();
+
+    // Lista de archivos sin repetir (un archivo puede coincidir con varias entradas).
+    vector<InputFile> files;
+    {
+        set<string> seen;
+        error_code ec;
+        for (const auto& in : inputs) {
+            for (const auto& p : expandInput(in)) {
+                fs::path canon = fs::weakly_canonical(p, ec);
+                if (!seen.insert(ec ? p : canon.string()).second) continue;
+                InputFile f;
+                f.path = p;
+                f.size = (uint64_t)fs::file_size(p, ec);
+                if (!ec) files.push_back(f);
+            }
+        }
+    }
+    if (files.empty()) {
+        cerr << "No hay archivos .gift para procesar." << endl;
+        return 1;
+    }
+
+    vector<Task> tasks;
+    uint64_t totalBytes = 0;
+    for (size_t i = 0; i < files.size(); i++) {
+        totalBytes += files[i].size;
+        uint64_t b = 0;
+        do {
+            uint64_t e = min(files[i].size, b + chunkBytes);
+            tasks.push_back({i, b, e});
+            b = e;
+        } while (b < files[i].size);
+    }
+
+    // Antes de lanzar los hilos: si no se pueden crear, no se parsea nada.
+    ofstream out(outPath, ios::binary);
+    ofstream report(reportPath, ios::binary);
+    if (!out || !report) {
+        cerr << "No se pudo crear " << (!out ? outPath : reportPath) << endl;
+        return 1;
+    }
+
+    // Hilos: toman bloques en orden; el hilo principal une los resultados en
+    // ese mismo orden apenas están listos y libera la memoria de cada bloque.
+    // Un hilo no se adelanta más de 'window' bloques al último unido: si la
+    // unión se atrasa, los resultados pendientes no crecen con el corpus.
+    vector<ChunkResult> results(tasks.size());
+    vector<char> ready(tasks.size(), 0);
+    mutex mtx;
+    condition_variable cv;
+    atomic<size_t> nextTask(0);
+    size_t merged = 0; // bloques ya unidos (protegido por mtx)
+
+    threads = (unsigned)min<size_t>(threads, tasks.size());
+    const size_t window = 2 * (size_t)threads;
+    vector<thread> pool;
+    for (unsigned w = 0; w < threads; w++) {
+        pool.emplace_back([&]() {
+            for (size_t i; (i = nextTask.fetch_add(1)) < tasks.size();) {
+                {
+                    unique_lock<mutex> lock(mtx);
+                    cv.wait(lock, [&]() { return i < merged + window; });
+                }
+                runTask(tasks[i], files, results[i]);
+                lock_guard<mutex> lock(mtx);
+                ready[i] = 1;
+                cv.notify_all();
+            }
+        });
+    }
+
+    struct Origin {
+        uint32_t file;
+        uint64_t line;
+    };
+    unordered_map<uint64_t, Origin> firstSeen;
+
+    size_t found = 0, kept = 0, dropped = 0, duplicates = 0, suspicious = 0;
+    uint64_t lineBase = 1;
+    size_t currentFile = SIZE_MAX;
+
+    for (size_t i = 0; i < tasks.size(); i++) {
+        {
+            unique_lock<mutex> lock(mtx);
+            cv.wait(lock, [&]() { return ready[i] != 0; });
+        }
+        ChunkResult& r = results[i];
+        const Task& t = tasks[i];
+        if (t.file != currentFile) {
+            currentFile = t.file;
+            lineBase = 1;
+        }
+        const string& path = files[t.file].path;
+
+        // El reporte sale ordenado por línea, sin importar el tamaño de bloque.
+        vector<pair<uint64_t, string>> lines;
+        for (const auto& is : r.issues) {
+            lines.push_back({is.line, (is.dropped ? "descartada: " : "sospechosa: ") + is.msg});
+            if (is.dropped) dropped++;
+            else suspicious++;
+        }
+
+        for (auto& q : r.qs) {
+            uint64_t line = lineBase + q.line;
+            auto ins = firstSeen.emplace(q.hash, Origin{(uint32_t)t.file, line});
+            if (!ins.second) {
+                const Origin& o = ins.first->second;
+                lines.push_back({q.line, "repetida: igual a " + files[o.file].path + ":" + to_string(o.line)});
+                duplicates++;
+                continue;
+            }
+
+            string where = path;
+            replace(where.begin(), where.end(), '{', '(');
+            replace(where.begin(), where.end(), '}', ')');
+            out << "// " << where << ":" << line << "\n" << q.gift;
+            kept++;
+        }
+
+        stable_sort(lines.begin(), lines.end(),
+                    [](const pair<uint64_t, string>& a, const pair<uint64_t, string>& b) { return a.first < b.first; });
+        for (const auto& ln : lines) report << path << ":" << (lineBase + ln.first) << ": " << ln.second << "\n";
+
+        found += r.found;
+        lineBase += r.newlines;
+        r = ChunkResult();
+        {
+            lock_guard<mutex> lock(mtx);
+            merged = i + 1;
+        }
+        cv.notify_all();
+    }
+
+    for (auto& th : pool) th.join();
+
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    double mb = totalBytes / (1024.0 * 1024.0);
+
+    report << "\nArchivos: " << files.size() << " | Preguntas: " << found
+           << " | En el banco: " << kept << " | Descartadas: " << dropped
+           << " | Repetidas: " << duplicates << " | Sospechosas: " << suspicious << "\n";
+
+    cout << "Archivos:     " << files.size() << " (" << mb << " MB, " << tasks.size() << " bloques)\n"
+         << "Preguntas:    " << found << "\n"
+         << "En el banco:  " << kept << " -> " << outPath << "\n"
+         << "Descartadas:  " << dropped << "\n"
+         << "Repetidas:    " << duplicates << "\n"
+         << "Sospechosas:  " << suspicious << " (detalle en " << reportPath << ")\n"
+         << "Tiempo:       " << secs << " s con " << threads << " hilos ("
+         << (secs > 0 ? mb / secs : 0) << " MB/s)" << endl;
+    return 0;
+}
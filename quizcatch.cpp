@@ -11,13 +11,15 @@
     └───────────────────────────────┘
     |                              |
     |-> Estudio: orden original, muestra respuesta correcta en verde
-    |-> Juego: mezcla preguntas, NO muestra respuesta correcta
+    |-> Juego: orden del planificador de repaso, NO muestra respuesta correcta
 4. Para cada pregunta:
     a) Muestra pregunta y opciones
     b) Al continuar, caen letras (opciones)
     c) El jugador mueve la paleta y atrapa una letra
     d) Si es correcta, suma acierto
-    e) Avanza a la siguiente pregunta
+    e) En modo juego con un jugador guarda las estadísticas de repaso de la
+       pregunta (quiz.stats); siempre encola la respuesta en la telemetría (quiz.telemetry.N, ver telemetry.h)
+    f) Avanza a la siguiente pregunta
 5. Al finalizar:
     - Si aciertos >= mínimo, gana
     - Si no, fin del juego
@@ -25,17 +27,18 @@
 // Lógica principal:
 
 main()
+  └─> layoutSessions(jugadores)
   └─> cargar preguntas
-  └─> initGameUI()
-  └─> state = MODE_SELECT
+  └─> initGameUI()   (cada sesión empieza en MODE_SELECT)
   └─> loop principal:
             └─> handleEvents()
-            └─> updateGame()
-            └─> renderGame()
+            └─> updateGame(sesión)   para cada jugador
+            └─> renderGame()         todas las pantallas, un solo present
 
 // Selección de modo:
 handleEvents()
-  └─> Si elige JUEGO: mezcla preguntas
+  └─> Si elige JUEGO: mezcla preguntas y arma el planificador
+    (heap por vencimiento, tasa de aciertos y demora de cada pregunta)
   └─> Si elige ESTUDIO: NO mezcla
 
 // Caída de letras:
@@ -51,8 +54,8 @@ renderFalling()
 Para compilar este juego con Emscripten y SDL2, usa:
 
 em++ quizcatch.cpp -o quiz.html -std=c++11 -O2 \
-  -s USE_SDL=2 -s USE_SDL_TTF=2 -s USE_FREETYPE=1 \
-  --preload-file arial.ttf --preload-file quiz.gift
+  -s USE_SDL=2 -s USE_SDL_TTF=2 -s USE_FREETYPE=1 -lidbfs.js \
+  --preload-file arial.ttf --preload-file quiz.gift --preload-file quiz.speeds
 
 Explicación de cada opción:
 - em++                → Compilador C++ de Emscripten
@@ -63,39 +66,102 @@ Explicación de cada opción:
 - -s USE_SDL=2        → Habilita SDL2 (gráficos, input)
 - -s USE_SDL_TTF=2    → Habilita SDL_ttf (texto TrueType)
 - -s USE_FREETYPE=1   → Habilita soporte de fuentes TTF
-- --preload-file ...  → Incluye archivos necesarios en el paquete (fuente y preguntas)
+- -lidbfs.js          → Enlaza IDBFS (IndexedDB) para guardar estadísticas entre sesiones
+- --preload-file ...  → Incluye archivos necesarios en el paquete (fuente, preguntas y
+                        velocidades de caída; quiz.speeds se genera con calibrate.cpp)
 
 NOTA: Si se compila para escritorio (no web), se debe enlazar SDL2 y SDL2_ttf según el sistema donde se ejecute.
 
+PERFIL LIVIANO (descarga más chica para redes escolares), el que se publica:
+
+em++ quizcatch.cpp -o quiz.html -std=c++11 -Oz -flto -fno-rtti \
+  -s USE_SDL=2 -s USE_SDL_TTF=2 -s USE_FREETYPE=1 -lidbfs.js \
+  -s ENVIRONMENT=web -s MALLOC=emmalloc -s ASSERTIONS=0 \
+  --closure 1 \
+  --preload-file arial.ttf --preload-file quiz.gift --preload-file quiz.speeds
+
+- -Oz -flto           → Optimiza por tamaño y entre unidades de compilación
+- -fno-rtti           → Sin información de tipos en tiempo de ejecución (no se usa)
+- ENVIRONMENT=web     → Quita del .js el soporte para Node.js y workers
+- MALLOC=emmalloc     → Asignador de memoria más chico que dlmalloc
+- ASSERTIONS=0        → Sin chequeos de depuración en el .js
+- --closure 1         → Minifica el .js con Closure Compiler
+
+PERFIL DE ANÁLISIS (no se publica): las mismas opciones más --profiling-funcs,
+que deja en el wasm la sección "name" con los nombres de las funciones para el
+reporte de wasmsize. Esa sección suma miles de nombres, por eso va aparte:
+
+mkdir -p analisis
+em++ quizcatch.cpp -o analisis/quiz.html -std=c++11 -Oz -flto -fno-rtti \
+  -s USE_SDL=2 -s USE_SDL_TTF=2 -s USE_FREETYPE=1 -lidbfs.js \
+  -s ENVIRONMENT=web -s MALLOC=emmalloc -s ASSERTIONS=0 \
+  --closure 1 --profiling-funcs \
+  --preload-file arial.ttf --preload-file quiz.gift --preload-file quiz.speeds
+
+El juego no usa <iostream>, <sstream> ni <fstream>: los mensajes salen por
+SDL_Log, el HUD se arma con SDL_snprintf y los archivos se leen con SDL_RWops.
+Al mostrar la primera pantalla interactiva escribe "[TTI] N ms" en la consola,
+y "[MEM]" con el tamaño del heap de wasm (en Linux, la memoria residente).
+
+Reporte de tamaño por sección y por función, con presupuesto: ver wasmsize.cpp.
+
+EQUIPOS SIN GPU (escritorio):
+
+Si el renderer es por software, el dibujo pasa por un framebuffer en memoria
+y solo se suben a la pantalla las regiones que cambiaron (ver "Dibujo").
+
+quizcatch quiz.gift --software      → fuerza el renderer por software
+quizcatch quiz.gift --no-fastpath   → dibuja como siempre, para comparar
+quizcatch quiz.gift --bench [N]     → mide FPS con N frames por pantalla, sin
+                                      ventana (driver dummy): el dibujo original
+                                      (una textura por texto), el de lotes y el
+                                      rápido, y la pantalla dividida de 1 a 4
+                                      jugadores
+
+PANTALLA DIVIDIDA (kioscos con varios jugadores):
+
+quizcatch quiz.gift --players N     → N de 1 a 4 (en la web: quiz.html?players=N)
+
+Cada jugador tiene su sesión (GameSession) y su parte de la ventana: dos lado a
+lado, tres o cuatro en una grilla de 2 x 2. El banco de preguntas, la fuente,
+el caché de textos y el envío de comandos de dibujo son compartidos.
+
+  Jugador 1: A/D mover, W seguir        Jugador 3: J/L mover, I seguir
+  Jugador 2: flechas, Arriba seguir     Jugador 4: 4/6 mover, 8 seguir (numérico)
+
+En la selección de modo, izquierda elige JUEGO y derecha ESTUDIO; también se
+puede hacer clic en la pantalla de cada uno. ESC sale; cuando todos terminaron,
+cualquier tecla. Con varios jugadores el modo JUEGO usa una mezcla propia por
+jugador (sin planificador), las respuestas no van a quiz.stats (solo a la
+telemetría, con el jugador) y la sesión en curso no se guarda.
+
 */
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <ctime>
-#include <fstream>
-#include <iostream>
-#include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "fallmodel.h"
+#include "telemetry.h"
+
 #ifdef __EMSCRIPTEN__
 #include <emscripten/emscripten.h>
 #endif
+#ifdef __linux__
+#include <unistd.h>
+#endif
 
 using namespace std;
 
-static const int W = 800;
-static const int H = 600;
-
-static const int PADDLE_WIDTH = 140;
-static const int PADDLE_HEIGHT = 12;
-
-static const int LETTER_SIZE = 28;
-static const int INITIAL_SPEED = 2;      // <- antes 5 (más lento al inicio)
-static const float SPEED_ACCEL = 0.005f; // <- antes 0.01f (acelera más suave)
-
 static const int BUTTON_WIDTH = 170;
 static const int BUTTON_HEIGHT = 52;
 
@@ -118,7 +184,6 @@ enum class PlayMode {
     STUDY
 };
 
-static PlayMode playMode = PlayMode::STUDY; // Por defecto modo estudio
 // ---------------------------------------
 
 
@@ -134,6 +199,32 @@ static string trim(const string& s) {
     return s.substr(a, b - a);
 }
 
+// Hash FNV-1a de 64 bits.
+static uint64_t fnv1a(const unsigned char* p, size_t n, uint64_t h = 1469598103934665603ULL) {
+    for (size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static uint64_t fnv1a(const string& s, uint64_t h = 1469598103934665603ULL) {
+    return fnv1a(reinterpret_cast<const unsigned char*>(s.data()), s.size(), h);
+}
+
+// Separa un texto en palabras (lo mismo que 'iss >> word', sin <sstream>).
+static vector<string> splitWords(const string& text) {
+    vector<string> words;
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && isspace(static_cast<unsigned char>(text[i]))) i++;
+        size_t start = i;
+        while (i < text.size() && !isspace(static_cast<unsigned char>(text[i]))) i++;
+        if (i > start) words.push_back(text.substr(start, i - start));
+    }
+    return words;
+}
+
 // Envuelve texto por ANCHO EN PIXELES (no por cantidad de chars).
 static vector<string> splitLinesWrapPixels(const string& text, int maxWidthPx) {
     vector<string> out;
@@ -142,9 +233,8 @@ static vector<string> splitLinesWrapPixels(const string& text, int maxWidthPx) {
     // Fallback si no hay fuente cargada: usa un wrap "por caracteres".
     if (!font) {
         const size_t approxChars = (maxWidthPx > 0) ? (size_t)max(10, maxWidthPx / 10) : 60;
-        istringstream iss(text);
-        string word, line;
-        while (iss >> word) {
+        string line;
+        for (const auto& word : splitWords(text)) {
             if (line.empty()) line = word;
             else if (line.size() + 1 + word.size() > approxChars) {
                 out.push_back(line);
@@ -164,8 +254,6 @@ static vector<string> splitLinesWrapPixels(const string& text, int maxWidthPx) {
         return w;
     };
 
-    istringstream iss(text);
-    string word;
     string line;
 
     auto flushLine = [&]() {
@@ -173,7 +261,7 @@ static vector<string> splitLinesWrapPixels(const string& text, int maxWidthPx) {
         line.clear();
     };
 
-    while (iss >> word) {
+    for (const auto& word : splitWords(text)) {
         if (line.empty()) {
             // Si una sola "palabra" ya no entra, la partimos.
             if (textWidth(word) <= maxWidthPx) {
@@ -221,25 +309,394 @@ static vector<string> splitLinesWrapPixels(const string& text, int maxWidthPx) {
     return out;
 }
 
+// Líneas ya envueltas de cada texto. Medir con la fuente es caro y la misma
+// pregunta se dibuja en cada frame, en la pantalla de cada jugador.
+static unordered_map<uint64_t, vector<string>> wrapCache;
+
+static const vector<string>& wrappedLines(const string& text, int maxWidthPx) {
+    uint64_t key = fnv1a(text, (uint64_t)maxWidthPx);
+    auto it = wrapCache.find(key);
+    if (it == wrapCache.end()) it = wrapCache.emplace(key, splitLinesWrapPixels(text, maxWidthPx)).first;
+    return it->second;
+}
+
+// ----------------------------------------
+// Dibujo: lista de comandos por frame
+// ----------------------------------------
+// Las primitivas de abajo no dibujan directo: anotan comandos (relleno, borde
+// o texto) y presentFrame() los envía todos juntos. Cada texto se renderiza
+// una sola vez y queda en un caché compartido por las pantallas de todos los
+// jugadores.
+//
+// Con GPU, los comandos de las distintas pantallas se intercalan y los
+// rellenos y bordes seguidos del mismo color salen en una sola llamada
+// (SDL_RenderFillRects / SDL_RenderDrawRects).
+//
+// Sin GPU (SDL_RENDERER_SOFTWARE) lo caro es pintar toda la ventana en cada
+// frame. En ese caso presentFrame() compara los comandos con los del frame
+// anterior, redibuja solo los rectángulos que cambiaron (letras que caen,
+// paleta, HUD) en un framebuffer en memoria, sube solo esas regiones a una
+// única textura streaming y copia a la ventana solo esas mismas regiones.
+
+enum : uint8_t { DRAW_FILL, DRAW_OUTLINE, DRAW_TEXT };
+
+// Texto ya renderizado: superficie en el camino por software, textura con GPU.
+struct CachedText {
+    SDL_Surface* surface = nullptr;
+    SDL_Texture* texture = nullptr;
+    int w = 0;
+    int h = 0;
+};
+
+struct DrawCmd {
+    uint64_t key = 0;     // tipo + rectángulo + color (+ texto)
+    SDL_Rect rect{};      // en coordenadas de la ventana
+    SDL_Rect clip{};      // pantalla del jugador que lo dibujó
+    SDL_Color color{};
+    uint8_t kind = DRAW_FILL;
+    uint32_t seq = 0;     // orden dentro de esa pantalla
+    const CachedText* text = nullptr;
+};
+
+static const size_t TEXT_CACHE_MAX = 512; // textos distintos antes de vaciar el caché
+static const int SW_MAX_DIRTY = 16;       // por pantalla de W x H; si hay más, se unen en uno
+
+static int winW = W; // la ventana tiene una pantalla de W x H por jugador
+static int winH = H;
+static bool forceSoftware = false; // --software: renderer por software aunque haya GPU
+static bool allowFastPath = true;  // --no-fastpath: sin regiones sucias (para comparar)
+static bool swFastPath = false;
+// Camino de antes, sin lotes ni caché: cada primitiva llama a SDL en el momento
+// y cada texto crea y destruye su textura. Solo lo usa --bench como referencia.
+static bool uncachedDraw = false;
+static SDL_Surface* swFrame = nullptr;
+static SDL_Texture* swTexture = nullptr;
+static vector<DrawCmd> drawCmds;
+static vector<DrawCmd> swPrevCmds;
+static SDL_Rect drawViewport = {0, 0, W, H};
+static uint32_t drawSeq = 0;
+static SDL_Color clearColor = {0, 0, 0, 255};
+static SDL_Color swPrevClearColor = {0, 0, 0, 255};
+static bool swFullRedraw = true;
+static unordered_map<uint64_t, CachedText> textCache;
+static uint64_t swUploadedPixels = 0; // píxeles subidos a la textura (para --bench)
+static uint64_t drawCalls = 0;        // llamadas de dibujo a SDL (para --bench)
+
+static bool sameColor(SDL_Color a, SDL_Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+static bool rectInside(const SDL_Rect& a, const SDL_Rect& b) {
+    return a.x >= b.x && a.y >= b.y && a.x + a.w <= b.x + b.w && a.y + a.h <= b.y + b.h;
+}
+
+static uint64_t colorSeed(SDL_Color c) {
+    const unsigned char bytes[4] = {c.r, c.g, c.b, c.a};
+    return fnv1a(bytes, sizeof bytes);
+}
+
+// Lo que se dibuje desde acá va a la pantalla 'viewport', con coordenadas
+// relativas a ella (cada jugador dibuja como si tuviera la ventana entera).
+static void setDrawViewport(const SDL_Rect& viewport) {
+    drawViewport = viewport;
+    drawSeq = 0;
+    if (uncachedDraw) SDL_RenderSetViewport(renderer, &viewport);
+}
+
+static void pushDrawCmd(uint8_t kind, const SDL_Rect& r, SDL_Color c, const CachedText* text, uint64_t textKey) {
+    DrawCmd cmd;
+    cmd.seq = drawSeq++;
+    cmd.rect = {r.x + drawViewport.x, r.y + drawViewport.y, r.w, r.h};
+    cmd.clip = drawViewport;
+    if (!SDL_HasIntersection(&cmd.rect, &cmd.clip)) return;
+    cmd.kind = kind;
+    cmd.color = c;
+    cmd.text = text;
+    const int32_t fields[5] = {kind, cmd.rect.x, cmd.rect.y, r.w, r.h};
+    cmd.key = fnv1a(reinterpret_cast<const unsigned char*>(fields), sizeof fields, colorSeed(c) ^ textKey);
+    drawCmds.push_back(cmd);
+}
+
+static void clearTextCache() {
+    for (auto& kv : textCache) {
+        if (kv.second.surface) SDL_FreeSurface(kv.second.surface);
+        if (kv.second.texture) SDL_DestroyTexture(kv.second.texture);
+    }
+    textCache.clear();
+}
+
+static void shutdownSoftwareFastPath() {
+    clearTextCache(); // las superficies del caché son del framebuffer
+    if (swTexture) SDL_DestroyTexture(swTexture);
+    if (swFrame) SDL_FreeSurface(swFrame);
+    swTexture = nullptr;
+    swFrame = nullptr;
+    drawCmds.clear();
+    swPrevCmds.clear();
+    swFastPath = false;
+}
+
+// Activa el camino rápido si el renderer que dio SDL es por software.
+static void initSoftwareFastPath() {
+    SDL_RendererInfo info;
+    if (!allowFastPath || !renderer || SDL_GetRendererInfo(renderer, &info) != 0) return;
+    if (!(info.flags & SDL_RENDERER_SOFTWARE)) return;
+
+    clearTextCache(); // las texturas del caché no sirven para el framebuffer
+    swFrame = SDL_CreateRGBSurfaceWithFormat(0, winW, winH, 32, SDL_PIXELFORMAT_ARGB8888);
+    swTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, winW, winH);
+    if (!swFrame || !swTexture) {
+        SDL_Log("Sin camino rapido por software: %s", SDL_GetError());
+        shutdownSoftwareFastPath();
+        return;
+    }
+    swFastPath = true;
+    swFullRedraw = true;
+    SDL_Log("Renderer por software: dibujo por regiones sucias activado");
+}
+
+// Empieza un frame nuevo pintado de un color.
+static void clearScreen(SDL_Color c) {
+    drawCmds.clear();
+    clearColor = c;
+    setDrawViewport({0, 0, winW, winH});
+    if (uncachedDraw) {
+        SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+        SDL_RenderClear(renderer);
+        drawCalls++;
+        return;
+    }
+    // Vaciar el caché solo entre frames: los comandos apuntan a sus entradas.
+    if (textCache.size() > TEXT_CACHE_MAX) {
+        clearTextCache();
+        swPrevCmds.clear();
+        swFullRedraw = true;
+    }
+}
+
+static void fillRect(const SDL_Rect& r, SDL_Color c) {
+    if (uncachedDraw) {
+        SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+        SDL_RenderFillRect(renderer, &r);
+        drawCalls++;
+        return;
+    }
+    pushDrawCmd(DRAW_FILL, r, c, nullptr, 0);
+}
+
+// Borde de 1 píxel por dentro del rectángulo (como SDL_RenderDrawRect).
+static void outlineRect(const SDL_Rect& r, SDL_Color c) {
+    if (uncachedDraw) {
+        SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+        SDL_RenderDrawRect(renderer, &r);
+        drawCalls++;
+        return;
+    }
+    pushDrawCmd(DRAW_OUTLINE, r, c, nullptr, 0);
+}
+
+// Texto renderizado una sola vez, en el formato que usa el camino activo.
+static const CachedText* cachedText(const string& text, SDL_Color color, uint64_t key) {
+    auto it = textCache.find(key);
+    if (it != textCache.end()) return &it->second;
+
+    SDL_Surface* rendered = TTF_RenderUTF8_Solid(font, text.c_str(), color);
+    if (!rendered) return nullptr;
+    CachedText t;
+    t.w = rendered->w;
+    t.h = rendered->h;
+    if (swFastPath) t.surface = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0);
+    else t.texture = SDL_CreateTextureFromSurface(renderer, rendered);
+    SDL_FreeSurface(rendered);
+    if (!t.surface && !t.texture) return nullptr;
+    return &(textCache[key] = t);
+}
+
+// Agrega un rectángulo sucio recortado a la ventana, uniéndolo con los que toca.
+static void addDirtyRect(vector<SDL_Rect>& dirty, SDL_Rect r) {
+    const SDL_Rect screen = {0, 0, winW, winH};
+    if (!SDL_IntersectRect(&r, &screen, &r)) return;
+
+    for (size_t i = 0; i < dirty.size();) {
+        SDL_Rect grown = {dirty[i].x - 1, dirty[i].y - 1, dirty[i].w + 2, dirty[i].h + 2};
+        if (SDL_HasIntersection(&grown, &r)) {
+            SDL_UnionRect(&dirty[i], &r, &r);
+            dirty[i] = dirty.back();
+            dirty.pop_back();
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+    dirty.push_back(r);
+
+    if ((int)dirty.size() > SW_MAX_DIRTY * (winW / W) * (winH / H)) {
+        SDL_Rect all = dirty[0];
+        for (const auto& d : dirty) SDL_UnionRect(&all, &d, &all);
+        dirty.assign(1, all);
+    }
+}
+
+// Rectángulos de los comandos que están en un frame y no en el otro: lo que
+// se movió deja sucia su posición vieja y la nueva.
+static void collectDirtyRects(vector<SDL_Rect>& dirty) {
+    static vector<pair<uint64_t, SDL_Rect>> cur, prev;
+    cur.clear();
+    prev.clear();
+    for (const auto& c : drawCmds) cur.push_back({c.key, c.rect});
+    for (const auto& c : swPrevCmds) prev.push_back({c.key, c.rect});
+    auto byKey = [](const pair<uint64_t, SDL_Rect>& a, const pair<uint64_t, SDL_Rect>& b) { return a.first < b.first; };
+    sort(cur.begin(), cur.end(), byKey);
+    sort(prev.begin(), prev.end(), byKey);
+
+    size_t i = 0, j = 0;
+    while (i < cur.size() || j < prev.size()) {
+        if (i < cur.size() && j < prev.size() && cur[i].first == prev[j].first) {
+            i++;
+            j++;
+        } else if (j >= prev.size() || (i < cur.size() && cur[i].first < prev[j].first)) {
+            addDirtyRect(dirty, cur[i++].second);
+        } else {
+            addDirtyRect(dirty, prev[j++].second);
+        }
+    }
+}
+
+// Redibuja una región del framebuffer con los comandos del frame y la sube a la textura.
+static void repaintRegion(const SDL_Rect& d) {
+    SDL_SetClipRect(swFrame, &d);
+    SDL_FillRect(swFrame, &d, SDL_MapRGBA(swFrame->format, clearColor.r, clearColor.g, clearColor.b, 255));
+
+    for (const auto& c : drawCmds) {
+        SDL_Rect clip;
+        if (!SDL_IntersectRect(&c.clip, &d, &clip) || !SDL_HasIntersection(&c.rect, &clip)) continue;
+        SDL_SetClipRect(swFrame, &clip);
+        Uint32 px = SDL_MapRGBA(swFrame->format, c.color.r, c.color.g, c.color.b, c.color.a);
+        if (c.kind == DRAW_FILL) {
+            SDL_FillRect(swFrame, &c.rect, px);
+        } else if (c.kind == DRAW_OUTLINE) {
+            const SDL_Rect& r = c.rect;
+            SDL_Rect edges[4] = {{r.x, r.y, r.w, 1}, {r.x, r.y + r.h - 1, r.w, 1},
+                                 {r.x, r.y, 1, r.h}, {r.x + r.w - 1, r.y, 1, r.h}};
+            SDL_FillRects(swFrame, edges, 4, px);
+        } else {
+            SDL_Rect dst = c.rect;
+            SDL_BlitSurface(c.text->surface, nullptr, swFrame, &dst);
+        }
+    }
+    SDL_SetClipRect(swFrame, nullptr);
+
+    const Uint8* pixels = static_cast<const Uint8*>(swFrame->pixels) + d.y * swFrame->pitch + d.x * 4;
+    SDL_UpdateTexture(swTexture, &d, pixels, swFrame->pitch);
+    swUploadedPixels += (uint64_t)d.w * d.h;
+    drawCalls++;
+}
+
+// Envía el frame al renderer, juntando en una llamada los rellenos y bordes
+// seguidos del mismo color. Lo que se sale de su pantalla va solo, recortado.
+static void submitBatched() {
+    static vector<SDL_Rect> batch;
+    SDL_SetRenderDrawColor(renderer, clearColor.r, clearColor.g, clearColor.b, clearColor.a);
+    SDL_RenderClear(renderer);
+    drawCalls++;
+
+    size_t i = 0;
+    while (i < drawCmds.size()) {
+        const DrawCmd& c = drawCmds[i];
+        bool inside = rectInside(c.rect, c.clip);
+        if (!inside) SDL_RenderSetClipRect(renderer, &c.clip);
+
+        if (c.kind == DRAW_TEXT) {
+            SDL_RenderCopy(renderer, c.text->texture, nullptr, &c.rect);
+            i++;
+        } else {
+            batch.assign(1, c.rect);
+            size_t j = i + 1;
+            while (inside && j < drawCmds.size() && drawCmds[j].kind == c.kind &&
+                   sameColor(drawCmds[j].color, c.color) && rectInside(drawCmds[j].rect, drawCmds[j].clip)) {
+                batch.push_back(drawCmds[j++].rect);
+            }
+            SDL_SetRenderDrawColor(renderer, c.color.r, c.color.g, c.color.b, c.color.a);
+            if (c.kind == DRAW_FILL) SDL_RenderFillRects(renderer, batch.data(), (int)batch.size());
+            else SDL_RenderDrawRects(renderer, batch.data(), (int)batch.size());
+            i = j;
+        }
+        drawCalls++;
+        if (!inside) SDL_RenderSetClipRect(renderer, nullptr);
+    }
+    SDL_RenderPresent(renderer);
+}
+
+// Muestra el frame.
+static void presentFrame() {
+    if (uncachedDraw) {
+        SDL_RenderSetViewport(renderer, nullptr);
+        SDL_RenderPresent(renderer);
+        return;
+    }
+    // Intercala las pantallas: el paso k de cada jugador queda junto al de los
+    // demás (dentro de una misma pantalla se conserva el orden).
+    auto bySeq = [](const DrawCmd& a, const DrawCmd& b) { return a.seq < b.seq; };
+    if (!is_sorted(drawCmds.begin(), drawCmds.end(), bySeq)) stable_sort(drawCmds.begin(), drawCmds.end(), bySeq);
+
+    if (!swFastPath) {
+        submitBatched();
+        return;
+    }
+
+    static vector<SDL_Rect> dirty;
+    dirty.clear();
+    if (swFullRedraw || !sameColor(clearColor, swPrevClearColor)) {
+        dirty.push_back({0, 0, winW, winH});
+    } else {
+        collectDirtyRects(dirty);
+        // Si cambió más de la mitad de la ventana conviene una sola subida completa.
+        long area = 0;
+        for (const auto& d : dirty) area += (long)d.w * d.h;
+        if (area > (long)winW * winH / 2) dirty.assign(1, SDL_Rect{0, 0, winW, winH});
+    }
+
+    for (const auto& d : dirty) repaintRegion(d);
+
+    // El renderer por software dibuja sobre la superficie de la ventana, que
+    // conserva el frame anterior: basta copiar lo que cambió, y si no cambió
+    // nada no hace falta presentar.
+    if (!dirty.empty()) {
+        for (const auto& d : dirty) {
+            SDL_RenderCopy(renderer, swTexture, &d, &d);
+            drawCalls++;
+        }
+        SDL_RenderPresent(renderer);
+    }
+
+    swPrevCmds.swap(drawCmds);
+    swPrevClearColor = clearColor;
+    swFullRedraw = false;
+}
+
 // Dibuja un texto en pantalla en la posición (x, y) con el color dado.
 static void drawText(const string& text, int x, int y, SDL_Color color) {
     if (!font) return;
-    SDL_Surface* surface = TTF_RenderUTF8_Solid(font, text.c_str(), color);
-    if (!surface) return;
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_Rect rect = {x, y, surface->w, surface->h};
-    SDL_RenderCopy(renderer, texture, nullptr, &rect);
-    SDL_DestroyTexture(texture);
-    SDL_FreeSurface(surface);
+    if (uncachedDraw) {
+        SDL_Surface* surface = TTF_RenderUTF8_Solid(font, text.c_str(), color);
+        if (!surface) return;
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+        SDL_Rect rect = {x, y, surface->w, surface->h};
+        SDL_RenderCopy(renderer, texture, nullptr, &rect);
+        drawCalls++;
+        SDL_DestroyTexture(texture);
+        SDL_FreeSurface(surface);
+        return;
+    }
+    uint64_t key = fnv1a(text, colorSeed(color));
+    const CachedText* t = cachedText(text, color, key);
+    if (t) pushDrawCmd(DRAW_TEXT, {x, y, t->w, t->h}, color, t, key);
 }
 
 // Dibuja un botón con etiqueta, fondo y color de texto especificados.
 static void drawButton(const string& label, SDL_Rect rect, SDL_Color bgColor, SDL_Color textColor) {
-    SDL_SetRenderDrawColor(renderer, bgColor.r, bgColor.g, bgColor.b, bgColor.a);
-    SDL_RenderFillRect(renderer, &rect);
-
-    SDL_SetRenderDrawColor(renderer, WHT.r, WHT.g, WHT.b, WHT.a);
-    SDL_RenderDrawRect(renderer, &rect);
+    fillRect(rect, bgColor);
+    outlineRect(rect, WHT);
 
     drawText(label, rect.x + 12, rect.y + 10, textColor);
 }
@@ -250,18 +707,47 @@ struct Choice {
     bool correct = false;
 };
 
+// Estadísticas de repaso de una pregunta (repetición espaciada estilo SM-2).
+struct QuestionStats {
+    uint64_t id = 0;           // hash del contenido de la pregunta
+    uint32_t due = 0;          // segundos Unix en que vuelve a tocar (0 = nunca vista)
+    uint32_t interval = 0;     // segundos hasta la próxima repetición
+    uint16_t ease = 250;       // factor de facilidad SM-2 (x100)
+    uint16_t reps = 0;         // aciertos consecutivos
+    uint16_t seen = 0;         // veces respondida
+    uint16_t hits = 0;         // veces acertada
+    uint32_t avgLatencyMs = 0; // tiempo medio de respuesta
+};
+
 struct Question {
     string prompt;
     vector<Choice> choices;
+    QuestionStats stats;
 };
 
+// Identificador estable de una pregunta: hash de enunciado y opciones.
+// No depende del orden en el archivo, así sobrevive a ediciones del banco.
+static uint64_t questionId(const Question& q) {
+    uint64_t h = fnv1a(q.prompt);
+    for (const auto& c : q.choices) {
+        h = fnv1a(c.correct ? "\n=" : "\n~", h);
+        h = fnv1a(c.text, h);
+    }
+    return h;
+}
+
 // Lee todo el contenido de un archivo de texto y lo retorna como string.
 static string readAllFile(const string& path) {
-    ifstream in(path);
-    if (!in) return {};
-    ostringstream ss;
-    ss << in.rdbuf();
-    return ss.str();
+    SDL_RWops* rw = SDL_RWFromFile(path.c_str(), "rb");
+    if (!rw) return {};
+    string out;
+    Sint64 size = SDL_RWsize(rw);
+    if (size > 0) {
+        out.resize((size_t)size);
+        out.resize(SDL_RWread(rw, &out[0], 1, out.size()));
+    }
+    SDL_RWclose(rw);
+    return out;
 }
 
 // Parsea preguntas en formato GIFT simple y devuelve un vector de Question.
@@ -332,6 +818,7 @@ static vector<Question> parseGiftSimple(const string& content) {
                                 [](const Choice& c) { return c.correct; });
 
         if (!q.prompt.empty() && q.choices.size() >= 2 && hasCorrect) {
+            q.stats.id = questionId(q);
             qs.push_back(q);
         }
 
@@ -355,62 +842,953 @@ struct FallingLetter {
     bool correct = false;
 };
 
-static SDL_Rect paddle{};
-static float fallSpeed = INITIAL_SPEED;
-static GameState state = GameState::MODE_SELECT;
-// Botones para elegir modo
-static SDL_Rect btnModoJuego{};
-static SDL_Rect btnModoEstudio{};
+// Teclas de cada jugador con pantalla dividida. Con un solo jugador valen las
+// de siempre: flechas o A/D, SPACE/ENTER, 1/2 y P.
+struct PlayerKeys {
+    SDL_Keycode left;   // en la selección de modo: JUEGO
+    SDL_Keycode right;  // en la selección de modo: ESTUDIO
+    SDL_Keycode action; // Continue
+    const char* move;   // nombres para mostrar en pantalla
+    const char* actionName;
+};
+
+static const int MAX_PLAYERS = 4;
+static const PlayerKeys PLAYER_KEYS[MAX_PLAYERS] = {
+    {SDLK_a, SDLK_d, SDLK_w, "A/D", "W"},
+    {SDLK_LEFT, SDLK_RIGHT, SDLK_UP, "Flechas", "Arriba"},
+    {SDLK_j, SDLK_l, SDLK_i, "J/L", "I"},
+    {SDLK_KP_4, SDLK_KP_6, SDLK_KP_8, "4/6 num", "8 num"},
+};
+
+// Partida de un jugador. Con pantalla dividida hay una por jugador; el banco
+// de preguntas, la fuente, el caché de textos y las estadísticas de repaso
+// son compartidos.
+struct GameSession {
+    int player = 0;
+    SDL_Rect viewport = {0, 0, W, H}; // su parte de la ventana
+    PlayerKeys keys = PLAYER_KEYS[0];
+    PlayMode playMode = PlayMode::STUDY; // Por defecto modo estudio
+    GameState state = GameState::MODE_SELECT;
+    SDL_Rect paddle{};
+    float fallSpeed = INITIAL_SPEED;
+    float fallAccel = SPEED_ACCEL;
+    vector<FallingLetter> falling;
+    vector<int> order;     // pantalla dividida: su propio orden de preguntas
+    int currentQ = 0;      // cantidad de preguntas ya respondidas en la sesión
+    int currentIdx = 0;    // índice en 'questions' de la pregunta en pantalla
+    int correctCount = 0;
+    Uint32 questionStartTicks = 0;
+    Uint32 fallStartTicks = 0; // momento en que se pulsó Continue
+    int paddleTravel = 0;      // píxeles recorridos por la paleta en la caída actual
+};
 
 static vector<Question> questions;
-static int currentQ = 0;
-static vector<FallingLetter> falling;
-static int correctCount = 0;
+static uint64_t bankHash = 0; // identifica el banco cargado (para validar la sesión guardada)
+static vector<GameSession> sessions; // una por jugador
 
+// Botones, en coordenadas de la pantalla de cada jugador
+static SDL_Rect btnModoJuego{};
+static SDL_Rect btnModoEstudio{};
 static SDL_Rect btnLeft{};
 static SDL_Rect btnRight{};
 static SDL_Rect btnContinue{};
 
 static bool gameRunning = true;
 
+// ----------------------------------------
+// Velocidad de caída por cantidad de opciones (quiz.speeds, ver fallmodel.h)
+// ----------------------------------------
+// Con más opciones las letras quedan más juntas y hay que moverse menos, pero
+// con más precisión. calibrate.cpp simula jugadores y elige, para cada
+// cantidad de opciones, la caída más rápida que mantiene la probabilidad de
+// atrapar la letra buscada en el objetivo. Sin tabla se usan las constantes.
+
+static FallSpeed speedTable[SPEED_TABLE_MAX_CHOICES + 1];
+
+// Carga la tabla de velocidades. Las líneas mal formadas se ignoran.
+static void loadSpeedTable(const string& text) {
+    int loaded = 0;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == string::npos) end = text.size();
+        string line = trim(text.substr(pos, end - pos));
+        pos = end + 1;
+        if (line.empty() || line[0] == '#') continue;
+
+        char* p = nullptr;
+        char* q = nullptr;
+        char* r = nullptr;
+        long choices = strtol(line.c_str(), &p, 10);
+        double initial = strtod(p, &q);
+        double accel = strtod(q, &r);
+        if (p == line.c_str() || q == p || r == q) continue;
+        if (choices < 1 || choices > SPEED_TABLE_MAX_CHOICES || initial <= 0 || accel < 0) continue;
+
+        speedTable[choices].initial = (float)initial;
+        speedTable[choices].accel = (float)accel;
+        loaded++;
+    }
+    if (loaded > 0) SDL_Log("[VELOCIDAD] %d entradas en %s", loaded, SPEED_TABLE_PATH);
+}
+
+static FallSpeed speedFor(size_t choices) {
+    return (choices <= (size_t)SPEED_TABLE_MAX_CHOICES) ? speedTable[choices] : FallSpeed();
+}
+
+// ----------------------------------------
+// Repetición espaciada: estadísticas persistentes y planificador
+// ----------------------------------------
+// El archivo base (quiz.stats) tiene un registro de tamaño fijo por pregunta.
+// Cada respuesta agrega un registro a un segmento chico (quiz.stats.1,
+// quiz.stats.2, ...) de hasta STATS_SEGMENT_RECORDS registros; al cargar se
+// leen la base y los segmentos en orden y gana el último registro de cada
+// pregunta. Cuando hay demasiados segmentos, la compactación los une en la base.
+//
+// En la web IDBFS guarda en IndexedDB cada archivo que cambió, entero: así
+// cada respuesta guarda solo su segmento (menos de 1 KB) y no la base, que con
+// bancos grandes ocupa megabytes.
+
+#ifdef __EMSCRIPTEN__
+static const char* STATS_PATH = "/persist/quiz.stats"; // IDBFS (IndexedDB)
+#else
+static const char* STATS_PATH = "quiz.stats";
+#endif
+
+static const char STATS_MAGIC[4] = {'Q', 'C', 'S', 'T'};
+static const uint32_t STATS_VERSION = 1;
+static const size_t STATS_HEADER_SIZE = 8;
+static const size_t STATS_RECORD_SIZE = 28;
+
+static const uint32_t RELEARN_SECONDS = 60;         // reintento tras un error
+static const uint32_t FIRST_INTERVAL = 10 * 60;     // tras el primer acierto
+static const uint32_t SECOND_INTERVAL = 24 * 3600;  // tras el segundo acierto seguido
+static const uint32_t MAX_INTERVAL = 365u * 24 * 3600;
+static const uint32_t FAST_ANSWER_MS = 10000;       // respuesta "fácil"
+static const uint32_t SLOW_ANSWER_MS = 20000;       // respuesta "con dificultad"
+
+static unordered_map<uint64_t, QuestionStats> statsById; // incluye preguntas de otros bancos
+static const uint32_t STATS_SEGMENT_RECORDS = 32; // registros por segmento
+static const uint32_t STATS_MAX_SEGMENTS = 256;    // más que esto: se compacta
+
+static size_t statsLogRecords = 0;       // registros en los segmentos, contando repetidos
+static uint32_t statsSegments = 0;       // segmentos quiz.stats.1 .. quiz.stats.N
+static uint32_t statsSegmentRecords = 0; // registros en el último segmento
+static bool statsFileValid = false;      // la base y todos los segmentos se leyeron bien
+static bool statsLoaded = false;
+
+// Heap binario indexado: la raíz es la pregunta que más urge repasar.
+static vector<int> schedHeap; // índices en 'questions'
+static vector<int> schedPos;  // posición de cada pregunta dentro de schedHeap
+
+static void putLE(unsigned char* p, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; i++) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static uint64_t getLE(const unsigned char* p, int bytes) {
+    uint64_t v = 0;
+    for (int i = bytes - 1; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+static void encodeStats(const QuestionStats& st, unsigned char* p) {
+    putLE(p, st.id, 8);
+    putLE(p + 8, st.due, 4);
+    putLE(p + 12, st.interval, 4);
+    putLE(p + 16, st.ease, 2);
+    putLE(p + 18, st.reps, 2);
+    putLE(p + 20, st.seen, 2);
+    putLE(p + 22, st.hits, 2);
+    putLE(p + 24, st.avgLatencyMs, 4);
+}
+
+static QuestionStats decodeStats(const unsigned char* p) {
+    QuestionStats st;
+    st.id = getLE(p, 8);
+    st.due = (uint32_t)getLE(p + 8, 4);
+    st.interval = (uint32_t)getLE(p + 12, 4);
+    st.ease = (uint16_t)getLE(p + 16, 2);
+    st.reps = (uint16_t)getLE(p + 18, 2);
+    st.seen = (uint16_t)getLE(p + 20, 2);
+    st.hits = (uint16_t)getLE(p + 22, 2);
+    st.avgLatencyMs = (uint32_t)getLE(p + 24, 4);
+    return st;
+}
+
+// En la web monta IndexedDB en /persist y trae su contenido (asíncrono).
+static void initPersistence() {
+#ifdef __EMSCRIPTEN__
+    EM_ASM(
+        FS.mkdir('/persist');
+        FS.mount(IDBFS, {}, '/persist');
+        Module.quizPersistReady = 0;
+        FS.syncfs(true, function(err) { Module.quizPersistReady = 1; });
+    );
+#endif
+}
+
+// Devuelve true cuando /persist ya tiene el contenido guardado.
+static bool persistenceReady() {
+#ifdef __EMSCRIPTEN__
+    return EM_ASM_INT({ return Module.quizPersistReady ? 1 : 0; }) != 0;
+#else
+    return true;
+#endif
+}
+
+// Vuelca /persist a IndexedDB sin lanzar dos syncfs a la vez.
+static void syncPersistence() {
+#ifdef __EMSCRIPTEN__
+    EM_ASM(
+        var run = function() {
+            Module.quizSyncing = 1;
+            FS.syncfs(false, function(err) {
+                Module.quizSyncing = 0;
+                if (Module.quizSyncPending) {
+                    Module.quizSyncPending = 0;
+                    run();
+                }
+            });
+        };
+        if (Module.quizSyncing) Module.quizSyncPending = 1;
+        else run();
+    );
+#endif
+}
+
+static string statsSegmentPath(uint32_t n) {
+    char suffix[16];
+    SDL_snprintf(suffix, sizeof suffix, ".%u", n);
+    return string(STATS_PATH) + suffix;
+}
+
+static bool writeStatsHeader(FILE* f) {
+    unsigned char header[STATS_HEADER_SIZE];
+    memcpy(header, STATS_MAGIC, sizeof STATS_MAGIC);
+    putLE(header + 4, STATS_VERSION, 4);
+    return fwrite(header, 1, sizeof header, f) == sizeof header;
+}
+
+// Lee un archivo de estadísticas (base o segmento) sobre statsById.
+// Devuelve los registros leídos, -1 si no existe o -2 si no es válido.
+static long readStatsFile(const string& path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return -1;
+    long records = -2;
+    unsigned char header[STATS_HEADER_SIZE];
+    if (fread(header, 1, sizeof header, f) == sizeof header &&
+        memcmp(header, STATS_MAGIC, sizeof STATS_MAGIC) == 0 &&
+        getLE(header + 4, 4) == STATS_VERSION) {
+        records = 0;
+        unsigned char rec[STATS_RECORD_SIZE];
+        while (fread(rec, 1, sizeof rec, f) == sizeof rec) {
+            QuestionStats st = decodeStats(rec);
+            statsById[st.id] = st;
+            records++;
+        }
+    }
+    fclose(f);
+    return records;
+}
+
+// Lee la base y los segmentos y asigna las estadísticas a las preguntas cargadas.
+static void loadStats() {
+    statsById.clear();
+    statsLogRecords = 0;
+    statsSegments = 0;
+    statsSegmentRecords = 0;
+
+    statsFileValid = readStatsFile(STATS_PATH) >= 0;
+    for (uint32_t n = 1;; n++) {
+        long records = readStatsFile(statsSegmentPath(n));
+        if (records == -1) break;
+        if (records < 0) {
+            statsFileValid = false; // la próxima respuesta compacta y lo descarta
+            break;
+        }
+        statsSegments = n;
+        statsSegmentRecords = (uint32_t)records;
+        statsLogRecords += (size_t)records;
+    }
+
+    for (auto& q : questions) {
+        auto it = statsById.find(q.stats.id);
+        if (it != statsById.end()) q.stats = it->second;
+    }
+    statsLoaded = true;
+}
+
+// Reescribe la base con un único registro por pregunta y borra los segmentos.
+// Si se corta entre el rename y el borrado, releer los segmentos da lo mismo.
+static bool compactStats() {
+    string tmp = string(STATS_PATH) + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "wb");
+    if (!f) return false;
+
+    bool ok = writeStatsHeader(f);
+    unsigned char rec[STATS_RECORD_SIZE];
+    for (const auto& kv : statsById) {
+        encodeStats(kv.second, rec);
+        ok = ok && fwrite(rec, 1, sizeof rec, f) == sizeof rec;
+    }
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) {
+        remove(tmp.c_str());
+        return false;
+    }
+
+    remove(STATS_PATH); // rename no reemplaza archivos existentes en Windows
+    if (rename(tmp.c_str(), STATS_PATH) != 0) return false;
+    // Los segmentos leídos y los que sigan (uno inválido corta la lectura).
+    for (uint32_t n = 1;; n++) {
+        bool removed = remove(statsSegmentPath(n).c_str()) == 0;
+        if (!removed && n > statsSegments) break;
+    }
+    statsLogRecords = 0;
+    statsSegments = 0;
+    statsSegmentRecords = 0;
+    statsFileValid = true;
+    return true;
+}
+
+// Agrega un registro al último segmento; si está lleno empieza uno nuevo.
+static void appendStats(const QuestionStats& st) {
+    bool fresh = statsSegments == 0 || statsSegmentRecords >= STATS_SEGMENT_RECORDS;
+    uint32_t n = fresh ? statsSegments + 1 : statsSegments;
+    FILE* f = fopen(statsSegmentPath(n).c_str(), fresh ? "wb" : "ab");
+    if (!f) return;
+
+    unsigned char rec[STATS_RECORD_SIZE];
+    encodeStats(st, rec);
+    bool ok = (!fresh || writeStatsHeader(f)) && fwrite(rec, 1, sizeof rec, f) == sizeof rec;
+    fclose(f);
+    if (!ok) {
+        statsFileValid = false;
+        return;
+    }
+    if (fresh) {
+        statsSegments = n;
+        statsSegmentRecords = 0;
+    }
+    statsSegmentRecords++;
+    statsLogRecords++;
+}
+
+// Guarda la estadística de una pregunta en el segmento actual.
+static void saveStats(const QuestionStats& st) {
+    statsById[st.id] = st;
+    if (!statsLoaded) return; // aún no se leyó el archivo: no pisarlo
+
+    if (!statsFileValid || statsSegments >= STATS_MAX_SEGMENTS || statsLogRecords >= 2 * statsById.size() + 64) {
+        compactStats();
+    } else {
+        appendStats(st);
+    }
+    syncPersistence();
+}
+
+// Actualiza las estadísticas tras responder (SM-2 simplificado, en segundos).
+static void recordAnswer(QuestionStats& st, bool correct, uint32_t latencyMs) {
+    int quality = !correct ? 1 : (latencyMs <= FAST_ANSWER_MS) ? 5 : (latencyMs <= SLOW_ANSWER_MS) ? 4 : 3;
+
+    if (quality < 3) {
+        st.reps = 0;
+        st.interval = RELEARN_SECONDS;
+    } else {
+        if (st.reps < UINT16_MAX) st.reps++;
+        if (st.reps == 1) st.interval = FIRST_INTERVAL;
+        else if (st.reps == 2) st.interval = SECOND_INTERVAL;
+        else st.interval = (uint32_t)min<uint64_t>((uint64_t)st.interval * st.ease / 100, MAX_INTERVAL);
+    }
+
+    int d = 5 - quality;
+    st.ease = (uint16_t)max(130, (int)st.ease + 10 - d * (8 + d * 2));
+    st.due = (uint32_t)time(nullptr) + st.interval;
+
+    st.avgLatencyMs = (st.seen == 0) ? latencyMs : (st.avgLatencyMs * 3 + latencyMs) / 4;
+    if (st.seen == UINT16_MAX) {
+        st.seen /= 2; // conserva la tasa de aciertos
+        st.hits /= 2;
+    }
+    st.seen++;
+    if (correct) st.hits++;
+}
+
+// Devuelve true si la pregunta a debe repasarse antes que b: primero la que
+// vence antes; a igualdad, la de menor tasa de aciertos y luego la más lenta.
+static bool schedBefore(int a, int b) {
+    const QuestionStats& x = questions[a].stats;
+    const QuestionStats& y = questions[b].stats;
+    if (x.due != y.due) return x.due < y.due;
+    uint32_t accX = (uint32_t)x.hits * y.seen;
+    uint32_t accY = (uint32_t)y.hits * x.seen;
+    if (accX != accY) return accX < accY;
+    if (x.avgLatencyMs != y.avgLatencyMs) return x.avgLatencyMs > y.avgLatencyMs;
+    return a < b;
+}
+
+static void schedSwap(int i, int j) {
+    swap(schedHeap[i], schedHeap[j]);
+    schedPos[schedHeap[i]] = i;
+    schedPos[schedHeap[j]] = j;
+}
+
+static void schedSiftUp(int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!schedBefore(schedHeap[i], schedHeap[parent])) break;
+        schedSwap(i, parent);
+        i = parent;
+    }
+}
+
+static void schedSiftDown(int i) {
+    int n = (int)schedHeap.size();
+    while (true) {
+        int best = i;
+        int l = 2 * i + 1;
+        int r = l + 1;
+        if (l < n && schedBefore(schedHeap[l], schedHeap[best])) best = l;
+        if (r < n && schedBefore(schedHeap[r], schedHeap[best])) best = r;
+        if (best == i) break;
+        schedSwap(i, best);
+        i = best;
+    }
+}
+
+// Arma el heap con todas las preguntas en O(n).
+static void schedBuild() {
+    int n = (int)questions.size();
+    schedHeap.resize(n);
+    schedPos.resize(n);
+    for (int i = 0; i < n; i++) {
+        schedHeap[i] = i;
+        schedPos[i] = i;
+    }
+    for (int i = n / 2 - 1; i >= 0; i--) schedSiftDown(i);
+}
+
+// Reubica una pregunta cuyas estadísticas cambiaron, en O(log n).
+static void schedUpdate(int q) {
+    if (schedHeap.empty()) return;
+    schedSiftUp(schedPos[q]);
+    schedSiftDown(schedPos[q]);
+}
+
+// Devuelve la pregunta que más urge repasar; evita repetir 'avoid' si hay otra.
+static int schedNext(int avoid) {
+    if (schedHeap.empty()) return 0;
+    if (schedHeap[0] != avoid || schedHeap.size() == 1) return schedHeap[0];
+    if (schedHeap.size() == 2 || schedBefore(schedHeap[1], schedHeap[2])) return schedHeap[1];
+    return schedHeap[2];
+}
+
+// ----------------------------------------
+// Telemetría de respuestas (formato en telemetry.h)
+// ----------------------------------------
+// El registro se reparte en segmentos que se reusan en anillo (quiz.telemetry.0
+// .. quiz.telemetry.63); se pasa al siguiente cuando el actual llega a
+// TELEMETRY_SEGMENT_BYTES, así que en total ocupa poco más de 512 KB. Cada
+// volcado solo cambia el segmento actual, que es lo único que IDBFS vuelve a
+// guardar. quiz.telemetry.seq tiene el número del segmento actual.
+//
+// exportTelemetry() une los segmentos en un solo archivo con el formato de
+// siempre para quiztelemetry: en la web lo descarga el navegador (F9) y en
+// escritorio queda en quiz.telemetry.export al salir.
+
+#ifdef __EMSCRIPTEN__
+static const char* TELEMETRY_PATH = "/persist/quiz.telemetry";
+static const char* TELEMETRY_EXPORT_PATH = "/tmp/quiz.telemetry.export"; // MEMFS: no se sincroniza
+#else
+static const char* TELEMETRY_PATH = "quiz.telemetry";
+static const char* TELEMETRY_EXPORT_PATH = "quiz.telemetry.export";
+#endif
+
+static const uint32_t TELEMETRY_BATCH = 64;
+static const Uint32 TELEMETRY_IDLE_FLUSH_MS = 2000;
+static const long TELEMETRY_SEGMENT_BYTES = 8 * 1024; // 256 eventos
+static const uint32_t TELEMETRY_SEGMENTS = 64;
+
+static TelemetryRing<256> telemetry;
+static Uint32 lastTelemetryFlush = 0;
+static uint32_t telemetrySeq = 0; // segmento actual: telemetrySeq % TELEMETRY_SEGMENTS
+static bool telemetrySeqLoaded = false;
+
+static bool snapshotDirty = false; // hubo un cambio de estado desde el último guardado
+
+// Encola un evento; no toca el disco.
+static void logEvent(TelemetryEvent ev, const GameSession& s) {
+    ev.timeMs = SDL_GetTicks();
+    ev.player = (uint8_t)s.player;
+    ev.questionNum = (uint32_t)s.currentQ;
+    telemetry.push(ev);
+}
+
+// Cambia el estado del juego registrando la transición.
+static void setState(GameSession& s, GameState next) {
+    if (next == s.state) return;
+    TelemetryEvent ev;
+    ev.type = TEV_STATE;
+    ev.fromState = (uint8_t)s.state;
+    ev.toState = (uint8_t)next;
+    if (s.currentIdx >= 0 && s.currentIdx < (int)questions.size()) ev.questionId = questions[s.currentIdx].stats.id;
+    logEvent(ev, s);
+    s.state = next;
+    snapshotDirty = true;
+}
+
+static string telemetryPath(const char* suffix) {
+    return string(TELEMETRY_PATH) + suffix;
+}
+
+static string telemetrySegmentPath(uint32_t seq) {
+    char suffix[16];
+    SDL_snprintf(suffix, sizeof suffix, ".%u", seq % TELEMETRY_SEGMENTS);
+    return telemetryPath(suffix);
+}
+
+static void writeTelemetryHeader(FILE* f) {
+    unsigned char header[TELEMETRY_HEADER_SIZE];
+    memcpy(header, TELEMETRY_MAGIC, sizeof TELEMETRY_MAGIC);
+    putLE(header + 4, TELEMETRY_VERSION, 4);
+    fwrite(header, 1, sizeof header, f);
+}
+
+// Lee el número del segmento actual (0 si el registro todavía no rotó).
+static void loadTelemetrySeq() {
+    telemetrySeqLoaded = true;
+    telemetrySeq = 0;
+    FILE* f = fopen(telemetryPath(".seq").c_str(), "rb");
+    if (!f) return;
+    if (fscanf(f, "%u", &telemetrySeq) != 1) telemetrySeq = 0;
+    fclose(f);
+}
+
+// Pasa al segmento siguiente, pisando el más viejo.
+static FILE* rotateTelemetry() {
+    telemetrySeq++;
+    FILE* seq = fopen(telemetryPath(".seq").c_str(), "wb");
+    if (seq) {
+        fprintf(seq, "%u\n", telemetrySeq);
+        fclose(seq);
+    }
+    FILE* f = fopen(telemetrySegmentPath(telemetrySeq).c_str(), "wb");
+    if (f) writeTelemetryHeader(f);
+    return f;
+}
+
+// Vuelca los eventos pendientes al segmento actual. Solo en frames ociosos
+// (fuera de la caída de letras), salvo que el buffer esté casi lleno o se pida 'force'.
+static void flushTelemetry(bool force) {
+    uint32_t pending = telemetry.size();
+    if (pending == 0 || !persistenceReady()) return;
+    if (!force && pending < telemetry.capacity() * 3 / 4) {
+        for (const GameSession& s : sessions) {
+            if (s.state == GameState::FALLING) return;
+        }
+        if (SDL_GetTicks() - lastTelemetryFlush < TELEMETRY_IDLE_FLUSH_MS) return;
+    }
+    if (!telemetrySeqLoaded) loadTelemetrySeq();
+
+    FILE* f = fopen(telemetrySegmentPath(telemetrySeq).c_str(), "ab");
+    if (!f) return;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    if (size == 0) {
+        writeTelemetryHeader(f);
+    } else if (size >= TELEMETRY_SEGMENT_BYTES) {
+        fclose(f);
+        f = rotateTelemetry();
+        if (!f) return;
+    }
+
+    uint32_t dropped = telemetry.takeDropped();
+    if (dropped > 0) {
+        TelemetryEvent ev;
+        ev.type = TEV_DROPPED;
+        ev.timeMs = SDL_GetTicks();
+        ev.answerMs = dropped;
+        fwrite(&ev, sizeof ev, 1, f);
+    }
+
+    TelemetryEvent batch[TELEMETRY_BATCH];
+    uint32_t n;
+    while ((n = telemetry.pop(batch, TELEMETRY_BATCH)) > 0) fwrite(batch, sizeof(TelemetryEvent), n, f);
+    fclose(f);
+
+    lastTelemetryFlush = SDL_GetTicks();
+    syncPersistence();
+}
+
+// Une los segmentos, del más viejo al más nuevo, en TELEMETRY_EXPORT_PATH con
+// una sola cabecera (lo que lee quiztelemetry). En la web además lo descarga.
+static void exportTelemetry() {
+    if (!persistenceReady()) return;
+    flushTelemetry(true);
+    if (!telemetrySeqLoaded) loadTelemetrySeq();
+
+    FILE* out = fopen(TELEMETRY_EXPORT_PATH, "wb");
+    if (!out) return;
+    writeTelemetryHeader(out);
+    uint32_t first = (telemetrySeq >= TELEMETRY_SEGMENTS) ? telemetrySeq - TELEMETRY_SEGMENTS + 1 : 0;
+    long events = 0;
+    for (uint32_t seq = first; seq <= telemetrySeq; seq++) {
+        FILE* f = fopen(telemetrySegmentPath(seq).c_str(), "rb");
+        if (!f) continue;
+        unsigned char header[TELEMETRY_HEADER_SIZE];
+        if (fread(header, 1, sizeof header, f) == sizeof header &&
+            memcmp(header, TELEMETRY_MAGIC, sizeof TELEMETRY_MAGIC) == 0 &&
+            getLE(header + 4, 4) == TELEMETRY_VERSION) {
+            TelemetryEvent batch[TELEMETRY_BATCH];
+            size_t n;
+            while ((n = fread(batch, sizeof(TelemetryEvent), TELEMETRY_BATCH, f)) > 0) {
+                fwrite(batch, sizeof(TelemetryEvent), n, out);
+                events += (long)n;
+            }
+        }
+        fclose(f);
+    }
+    fclose(out);
+    SDL_Log("[TELEMETRIA] %ld eventos exportados a %s", events, TELEMETRY_EXPORT_PATH);
+
+#ifdef __EMSCRIPTEN__
+    EM_ASM({
+        var data = FS.readFile(UTF8ToString($0));
+        var url = URL.createObjectURL(new Blob([data], {type: 'application/octet-stream'}));
+        var a = document.createElement('a');
+        a.href = url;
+        a.download = 'quiz.telemetry.export';
+        document.body.appendChild(a);
+        a.click();
+        a.remove();
+        setTimeout(function() { URL.revokeObjectURL(url); }, 1000);
+    }, TELEMETRY_EXPORT_PATH);
+#endif
+}
+
+// ----------------------------------------
+// Guardado y restauración de la sesión en curso
+// ----------------------------------------
+// Dos blobs binarios versionados:
+//   - orden: permutación de las preguntas, se escribe una vez al elegir modo
+//   - sesión: modo, estado, puntaje y letras en caída (209 bytes fijos), se
+//     escribe al final de cada frame con cambio de estado y cada medio
+//     segundo durante la caída
+// En la web van a localStorage (síncrono, así se restauran antes del primer
+// frame); en escritorio, a archivos. El de sesión queda abierto y se
+// reescribe en el lugar: ~1 us contra ~60 us de abrirlo y cerrarlo cada vez.
+
+static const char* SNAPSHOT_KEY = "quiz.snapshot";
+static const char* ORDER_KEY = "quiz.order";
+static const char SNAPSHOT_MAGIC[4] = {'Q', 'C', 'S', 'S'};
+static const char ORDER_MAGIC[4] = {'Q', 'C', 'S', 'O'};
+static const uint16_t SNAPSHOT_VERSION = 1;
+static const size_t SNAPSHOT_FIXED_SIZE = 49;  // sin letras ni checksum
+static const size_t SNAPSHOT_LETTER_SIZE = 6;
+static const size_t SNAPSHOT_MAX_LETTERS = 26;
+static const size_t SNAPSHOT_SIZE = SNAPSHOT_FIXED_SIZE + SNAPSHOT_MAX_LETTERS * SNAPSHOT_LETTER_SIZE + 4;
+static const size_t ORDER_FIXED_SIZE = 20;
+static const Uint32 SNAPSHOT_FALLING_MS = 500;
+static const double SNAPSHOT_BUDGET_US = 100.0;
+
+static vector<uint32_t> questionOrder; // índices originales; vacío = orden del archivo
+static Uint32 lastSnapshotTicks = 0;
+static int snapshotWrites = 0;
+static double snapshotUsTotal = 0.0;
+static double snapshotUsMax = 0.0;
+#ifndef __EMSCRIPTEN__
+static FILE* snapshotFile = nullptr;
+#endif
+
+// Guarda un blob bajo 'key'. Devuelve true si se pudo escribir.
+static bool storeBlob(const char* key, const unsigned char* data, size_t size) {
+#ifdef __EMSCRIPTEN__
+    return EM_ASM_INT({
+        try {
+            var bytes = HEAPU8.subarray($1, $1 + $2);
+            var s = '';
+            for (var i = 0; i < bytes.length; i += 0x8000) {
+                s += String.fromCharCode.apply(null, bytes.subarray(i, i + 0x8000));
+            }
+            localStorage.setItem('quizcatch/' + UTF8ToString($0), btoa(s));
+            return 1;
+        } catch (e) {
+            return 0;
+        }
+    }, key, data, (int)size) != 0;
+#else
+    FILE* f = fopen(key, "wb");
+    if (!f) return false;
+    bool ok = fwrite(data, 1, size, f) == size;
+    return (fclose(f) == 0) && ok;
+#endif
+}
+
+// Lee el blob guardado bajo 'key'. Devuelve false si no existe.
+static bool loadBlob(const char* key, vector<unsigned char>& data) {
+#ifdef __EMSCRIPTEN__
+    int len = EM_ASM_INT({
+        try {
+            var s = localStorage.getItem('quizcatch/' + UTF8ToString($0));
+            if (!s) return 0;
+            Module.quizBlob = atob(s);
+            return Module.quizBlob.length;
+        } catch (e) {
+            return 0;
+        }
+    }, key);
+    if (len <= 0) return false;
+    data.resize(len);
+    EM_ASM({
+        var b = Module.quizBlob;
+        for (var i = 0; i < $1; i++) HEAPU8[$0 + i] = b.charCodeAt(i);
+        Module.quizBlob = null;
+    }, data.data(), len);
+    return true;
+#else
+    FILE* f = fopen(key, "rb");
+    if (!f) return false;
+    data.clear();
+    unsigned char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof buf, f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+    return !data.empty();
+#endif
+}
+
+static void removeBlob(const char* key) {
+#ifdef __EMSCRIPTEN__
+    EM_ASM({
+        try {
+            localStorage.removeItem('quizcatch/' + UTF8ToString($0));
+        } catch (e) {
+        }
+    }, key);
+#else
+    remove(key);
+#endif
+}
+
+// Verifica cabecera, versión y checksum (últimos 4 bytes) de un blob.
+static bool checkBlob(const vector<unsigned char>& b, const char magic[4], size_t minSize) {
+    if (b.size() < minSize + 4) return false;
+    if (memcmp(b.data(), magic, 4) != 0 || getLE(b.data() + 4, 2) != SNAPSHOT_VERSION) return false;
+    if (getLE(b.data() + 8, 8) != bankHash) return false;
+    uint32_t sum = (uint32_t)fnv1a(b.data(), b.size() - 4);
+    return getLE(b.data() + b.size() - 4, 4) == sum;
+}
+
+// Guarda el orden de las preguntas elegido para esta sesión.
+static void saveOrder() {
+    vector<unsigned char> b(ORDER_FIXED_SIZE + 4 * questionOrder.size() + 4);
+    memcpy(b.data(), ORDER_MAGIC, 4);
+    putLE(&b[4], SNAPSHOT_VERSION, 2);
+    putLE(&b[6], 0, 2);
+    putLE(&b[8], bankHash, 8);
+    putLE(&b[16], questionOrder.size(), 4);
+    for (size_t i = 0; i < questionOrder.size(); i++) putLE(&b[ORDER_FIXED_SIZE + 4 * i], questionOrder[i], 4);
+    putLE(&b[b.size() - 4], (uint32_t)fnv1a(b.data(), b.size() - 4), 4);
+    storeBlob(ORDER_KEY, b.data(), b.size());
+}
+
+// Reordena 'questions' según una permutación de índices originales.
+static void applyOrder(const vector<uint32_t>& order) {
+    vector<Question> reordered;
+    reordered.reserve(order.size());
+    for (uint32_t i : order) reordered.push_back(std::move(questions[i]));
+    questions.swap(reordered);
+}
+
+// Serializa la sesión en 'buf' (SNAPSHOT_SIZE bytes, letras sin usar en cero).
+// Solo se guarda con un jugador: es la sesión 0.
+static void encodeSnapshot(unsigned char* buf) {
+    const GameSession& s = sessions[0];
+    Uint32 now = SDL_GetTicks();
+    size_t letters = min(s.falling.size(), SNAPSHOT_MAX_LETTERS);
+    uint32_t speedBits;
+    memcpy(&speedBits, &s.fallSpeed, sizeof speedBits);
+
+    memset(buf, 0, SNAPSHOT_SIZE);
+    memcpy(buf, SNAPSHOT_MAGIC, 4);
+    putLE(buf + 4, SNAPSHOT_VERSION, 2);
+    buf[6] = (unsigned char)s.playMode;
+    buf[7] = (unsigned char)s.state;
+    putLE(buf + 8, bankHash, 8);
+    putLE(buf + 16, (uint32_t)s.currentQ, 4);
+    putLE(buf + 20, (uint32_t)s.currentIdx, 4);
+    putLE(buf + 24, (uint32_t)s.correctCount, 4);
+    putLE(buf + 28, (uint32_t)s.paddle.x, 4);
+    putLE(buf + 32, speedBits, 4);
+    putLE(buf + 36, now - s.questionStartTicks, 4);
+    putLE(buf + 40, now - s.fallStartTicks, 4);
+    putLE(buf + 44, (uint32_t)s.paddleTravel, 4);
+    buf[48] = (unsigned char)letters;
+
+    unsigned char* p = buf + SNAPSHOT_FIXED_SIZE;
+    for (size_t i = 0; i < letters; i++, p += SNAPSHOT_LETTER_SIZE) {
+        putLE(p, (uint16_t)s.falling[i].rect.x, 2);
+        putLE(p + 2, (uint16_t)s.falling[i].rect.y, 2);
+        p[4] = (unsigned char)s.falling[i].label;
+        p[5] = s.falling[i].correct ? 1 : 0;
+    }
+    putLE(buf + SNAPSHOT_SIZE - 4, (uint32_t)fnv1a(buf, SNAPSHOT_SIZE - 4), 4);
+}
+
+static void closeSnapshotFile() {
+#ifndef __EMSCRIPTEN__
+    if (snapshotFile) fclose(snapshotFile);
+    snapshotFile = nullptr;
+#endif
+}
+
+// Guarda la sesión y mide cuánto tarda. Al terminar la partida la borra.
+static void saveSnapshot() {
+    const GameSession& s = sessions[0];
+    snapshotDirty = false;
+    lastSnapshotTicks = SDL_GetTicks();
+    if (s.state == GameState::MODE_SELECT) return;
+    if (s.state == GameState::GAME_OVER || s.state == GameState::GAME_WIN) {
+        closeSnapshotFile();
+        removeBlob(SNAPSHOT_KEY);
+        removeBlob(ORDER_KEY);
+        return;
+    }
+
+    Uint64 t0 = SDL_GetPerformanceCounter();
+    unsigned char buf[SNAPSHOT_SIZE];
+    encodeSnapshot(buf);
+#ifdef __EMSCRIPTEN__
+    storeBlob(SNAPSHOT_KEY, buf, sizeof buf);
+#else
+    if (!snapshotFile) snapshotFile = fopen(SNAPSHOT_KEY, "wb");
+    if (snapshotFile) {
+        fseek(snapshotFile, 0, SEEK_SET);
+        fwrite(buf, 1, sizeof buf, snapshotFile);
+        fflush(snapshotFile);
+    }
+#endif
+    double us = (double)(SDL_GetPerformanceCounter() - t0) * 1e6 / (double)SDL_GetPerformanceFrequency();
+
+    snapshotWrites++;
+    snapshotUsTotal += us;
+    snapshotUsMax = max(snapshotUsMax, us);
+    if (us > SNAPSHOT_BUDGET_US) {
+        SDL_Log("[SESION] Guardado de %d us (presupuesto: %d us)", (int)us, (int)SNAPSHOT_BUDGET_US);
+    }
+}
+
+// Restaura la sesión guardada si corresponde a este mismo banco de preguntas.
+static bool restoreSession() {
+    GameSession& s = sessions[0];
+    vector<unsigned char> order, snap;
+    if (!loadBlob(ORDER_KEY, order) || !loadBlob(SNAPSHOT_KEY, snap)) return false;
+    if (!checkBlob(order, ORDER_MAGIC, ORDER_FIXED_SIZE) || !checkBlob(snap, SNAPSHOT_MAGIC, SNAPSHOT_FIXED_SIZE)) return false;
+
+    // Orden: vacío o una permutación completa de las preguntas cargadas.
+    size_t n = (size_t)getLE(&order[16], 4);
+    if (order.size() != ORDER_FIXED_SIZE + 4 * n + 4 || (n != 0 && n != questions.size())) return false;
+    vector<uint32_t> perm(n);
+    vector<bool> used(n, false);
+    for (size_t i = 0; i < n; i++) {
+        perm[i] = (uint32_t)getLE(&order[ORDER_FIXED_SIZE + 4 * i], 4);
+        if (perm[i] >= n || used[perm[i]]) return false;
+        used[perm[i]] = true;
+    }
+
+    const unsigned char* b = snap.data();
+    size_t letters = b[48];
+    GameState st = (GameState)b[7];
+    uint32_t q = (uint32_t)getLE(b + 16, 4);
+    uint32_t idx = (uint32_t)getLE(b + 20, 4);
+    if (snap.size() != SNAPSHOT_SIZE || letters > SNAPSHOT_MAX_LETTERS) return false;
+    if (st != GameState::SHOW_QUESTION && st != GameState::FALLING) return false;
+    if (b[6] != (unsigned char)PlayMode::GAME && b[6] != (unsigned char)PlayMode::STUDY) return false;
+    if (q >= questions.size() || idx >= questions.size()) return false;
+
+    if (n > 0) applyOrder(perm);
+    questionOrder = perm;
+
+    Uint32 now = SDL_GetTicks();
+    uint32_t speedBits = (uint32_t)getLE(b + 32, 4);
+    s.playMode = (PlayMode)b[6];
+    s.currentQ = (int)q;
+    s.currentIdx = (int)idx;
+    s.correctCount = (int)getLE(b + 24, 4);
+    s.paddle.x = (int)(int32_t)getLE(b + 28, 4);
+    memcpy(&s.fallSpeed, &speedBits, sizeof s.fallSpeed);
+    s.questionStartTicks = now - (Uint32)getLE(b + 36, 4);
+    s.fallStartTicks = now - (Uint32)getLE(b + 40, 4);
+    s.paddleTravel = (int)getLE(b + 44, 4);
+
+    s.falling.clear();
+    const unsigned char* p = b + SNAPSHOT_FIXED_SIZE;
+    for (size_t i = 0; i < letters; i++, p += SNAPSHOT_LETTER_SIZE) {
+        FallingLetter fl;
+        fl.rect = {(int16_t)getLE(p, 2), (int16_t)getLE(p + 2, 2), LETTER_SIZE, LETTER_SIZE};
+        fl.label = (char)p[4];
+        fl.correct = p[5] != 0;
+        s.falling.push_back(fl);
+    }
+    if (st == GameState::FALLING && s.falling.empty()) st = GameState::SHOW_QUESTION;
+    s.state = st;
+    s.fallAccel = speedFor(questions[s.currentIdx].choices.size()).accel;
+
+    SDL_Log("[SESION] Restaurada en la pregunta %d/%d", s.currentQ + 1, (int)questions.size());
+    return true;
+}
+
 // Inicializa SDL2, la ventana, el renderer y la fuente. Devuelve true si tuvo éxito.
 static bool initSDL() {
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-        cout << "Error SDL: " << SDL_GetError() << endl;
+        SDL_Log("Error SDL: %s", SDL_GetError());
         return false;
     }
 
     window = SDL_CreateWindow("Quiz Catch (GIFT) - SDL2",
                               SDL_WINDOWPOS_CENTERED,
                               SDL_WINDOWPOS_CENTERED,
-                              W, H,
+                              winW, winH,
                               SDL_WINDOW_SHOWN);
     if (!window) {
-        cout << "Error ventana: " << SDL_GetError() << endl;
+        SDL_Log("Error ventana: %s", SDL_GetError());
         return false;
     }
 
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    if (!forceSoftware) renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
     if (!renderer) renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
     if (!renderer) {
-        cout << "Error renderer: " << SDL_GetError() << endl;
+        SDL_Log("Error renderer: %s", SDL_GetError());
         return false;
     }
 
     if (TTF_Init() < 0) {
-        cout << "Error TTF: " << TTF_GetError() << endl;
+        SDL_Log("Error TTF: %s", TTF_GetError());
         return false;
     }
 
     font = TTF_OpenFont("C:/Windows/Fonts/arial.ttf", 22);
     if (!font) font = TTF_OpenFont("arial.ttf", 22);
 
+    initSoftwareFastPath();
     srand((unsigned)time(nullptr));
     return true;
 }
 
 // Libera recursos de SDL2 y cierra la aplicación.
 static void cleanup() {
+#ifdef __EMSCRIPTEN__
+    flushTelemetry(true);
+#else
+    // Deja quiz.telemetry.export listo para quiztelemetry (si esta ejecución registró algo).
+    if (telemetrySeqLoaded || telemetry.size() > 0) exportTelemetry();
+#endif
+    if (snapshotWrites > 0) {
+        SDL_Log("[SESION] %d guardados, promedio %d us, maximo %d us",
+                snapshotWrites, (int)(snapshotUsTotal / snapshotWrites), (int)snapshotUsMax);
+    }
+    closeSnapshotFile();
+    shutdownSoftwareFastPath();
     if (font) TTF_CloseFont(font);
     if (renderer) SDL_DestroyRenderer(renderer);
     if (window) SDL_DestroyWindow(window);
@@ -418,9 +1796,26 @@ static void cleanup() {
     SDL_Quit();
 }
 
+// Crea una sesión por jugador y reparte la ventana: uno solo usa W x H como
+// siempre, dos van lado a lado y tres o cuatro en una grilla de 2 x 2.
+static void layoutSessions(int players) {
+    players = max(1, min(players, MAX_PLAYERS));
+    int cols = (players == 1) ? 1 : 2;
+    int rows = (players + cols - 1) / cols;
+    winW = cols * W;
+    winH = rows * H;
+
+    sessions.assign(players, GameSession());
+    for (int i = 0; i < players; i++) {
+        sessions[i].player = i;
+        sessions[i].keys = PLAYER_KEYS[i];
+        sessions[i].viewport = {(i % cols) * W, (i / cols) * H, W, H};
+    }
+}
+
 // Inicializa la posición de la paleta y los botones de la UI.
 static void initGameUI() {
-    paddle = {W / 2 - PADDLE_WIDTH / 2, H - 40, PADDLE_WIDTH, PADDLE_HEIGHT};
+    for (auto& s : sessions) s.paddle = {W / 2 - PADDLE_WIDTH / 2, PADDLE_Y, PADDLE_WIDTH, PADDLE_HEIGHT};
 
     int margin = 18;
     btnLeft = {margin, H - BUTTON_HEIGHT - margin, BUTTON_WIDTH, BUTTON_HEIGHT};
@@ -440,47 +1835,107 @@ static int neededToWin() {
 
 // Genera las letras (opciones) que caen para la pregunta actual.
 // Si el modo es JUEGO, mezcla aleatoriamente las opciones y reasigna las letras.
-static void spawnLettersForCurrentQuestion() {
-    falling.clear();
-    if (currentQ < 0 || currentQ >= (int)questions.size()) return;
+static void spawnLettersForCurrentQuestion(GameSession& s) {
+    s.falling.clear();
+    if (s.currentIdx < 0 || s.currentIdx >= (int)questions.size()) return;
 
     // Usar las opciones en el orden original
-    const auto& choices = questions[currentQ].choices;
+    const auto& choices = questions[s.currentIdx].choices;
     int n = (int)choices.size();
     if (n <= 0) return;
 
-    int topY = 150;
-    int leftPad = 40;
-    int rightPad = 40;
-    int usable = W - leftPad - rightPad;
-
     for (int i = 0; i < n; i++) {
-        float t = (n == 1) ? 0.5f : (float)i / (float)(n - 1);
-        int x = leftPad + (int)(t * usable) - LETTER_SIZE / 2;
-
         FallingLetter fl;
         fl.label = choices[i].label;
         fl.correct = choices[i].correct;
-        fl.rect = {x, topY, LETTER_SIZE, LETTER_SIZE};
-        falling.push_back(fl);
+        fl.rect = {letterX(i, n), LETTER_TOP_Y, LETTER_SIZE, LETTER_SIZE};
+        s.falling.push_back(fl);
+    }
+
+    FallSpeed speed = speedFor(choices.size());
+    s.fallSpeed = speed.initial;
+    s.fallAccel = speed.accel;
+    s.fallStartTicks = SDL_GetTicks();
+    s.paddleTravel = 0;
+}
+
+// Aplica el modo elegido en la pantalla inicial y muestra la primera pregunta.
+// En modo JUEGO el orden lo decide el planificador; la mezcla desempata las nuevas.
+// Con pantalla dividida 'questions' es de todos y no se reordena: cada jugador
+// en modo JUEGO recorre su propia mezcla, sin planificador.
+static void selectMode(GameSession& s, PlayMode mode) {
+    if (!statsLoaded) return; // en la web IDBFS puede no haber terminado de cargar
+
+    s.playMode = mode;
+    if (sessions.size() > 1) {
+        s.order.clear();
+        if (mode == PlayMode::GAME) {
+            s.order.resize(questions.size());
+            for (size_t i = 0; i < s.order.size(); i++) s.order[i] = (int)i;
+            std::random_shuffle(s.order.begin(), s.order.end());
+        }
+        s.currentIdx = s.order.empty() ? 0 : s.order[0];
+        s.questionStartTicks = SDL_GetTicks();
+        setState(s, GameState::SHOW_QUESTION);
+        return;
     }
 
-    fallSpeed = (float)INITIAL_SPEED;
+    questionOrder.clear();
+    if (mode == PlayMode::GAME) {
+        // Mensaje por consola antes de mezclar
+        SDL_Log("[MODO JUEGO] Mezclando preguntas aleatoriamente...");
+        questionOrder.resize(questions.size());
+        for (size_t i = 0; i < questionOrder.size(); i++) questionOrder[i] = (uint32_t)i;
+        std::random_shuffle(questionOrder.begin(), questionOrder.end());
+        applyOrder(questionOrder);
+        schedBuild();
+        s.currentIdx = schedNext(-1);
+    } else {
+        s.currentIdx = 0;
+    }
+    saveOrder();
+    s.questionStartTicks = SDL_GetTicks();
+    setState(s, GameState::SHOW_QUESTION);
 }
 
-// Procesa la respuesta atrapada: suma acierto si es correcta y avanza de pregunta.
-static void handleAnswerCaught(const FallingLetter& caught) {
-    if (caught.correct) correctCount++;
+// Procesa la respuesta atrapada: suma acierto si es correcta, actualiza las
+// estadísticas de repaso (solo en modo juego con un jugador) y avanza de pregunta.
+static void handleAnswerCaught(GameSession& s, const FallingLetter& caught) {
+    if (caught.correct) s.correctCount++;
+
+    QuestionStats& st = questions[s.currentIdx].stats;
+
+    TelemetryEvent ev;
+    ev.type = TEV_ANSWER;
+    ev.questionId = st.id;
+    ev.label = (uint8_t)caught.label;
+    ev.correct = caught.correct ? 1 : 0;
+    ev.answerMs = SDL_GetTicks() - s.fallStartTicks;
+    ev.paddleTravel = (uint16_t)min(s.paddleTravel, 65535);
+    ev.fallSpeed = s.fallSpeed;
+    logEvent(ev, s);
+
+    // En estudio la correcta se ve en verde: atraparla no dice si se sabía,
+    // así que no cuenta para el planificador. Con pantalla dividida tampoco:
+    // quiz.stats es de un solo alumno y la telemetría ya separa por jugador.
+    if (s.playMode == PlayMode::GAME && sessions.size() == 1) {
+        recordAnswer(st, caught.correct, SDL_GetTicks() - s.questionStartTicks);
+        saveStats(st);
+        schedUpdate(s.currentIdx);
+    }
 
-    currentQ++;
+    s.currentQ++;
 
-    if (currentQ >= (int)questions.size()) {
-        state = (correctCount >= neededToWin()) ? GameState::GAME_WIN : GameState::GAME_OVER;
+    if (s.currentQ >= (int)questions.size()) {
+        setState(s, (s.correctCount >= neededToWin()) ? GameState::GAME_WIN : GameState::GAME_OVER);
         return;
     }
 
-    state = GameState::SHOW_QUESTION;
-    falling.clear();
+    if (!s.order.empty()) s.currentIdx = s.order[s.currentQ];
+    else s.currentIdx = (s.playMode == PlayMode::GAME) ? schedNext(s.currentIdx) : s.currentQ;
+    s.questionStartTicks = SDL_GetTicks();
+    setState(s, GameState::SHOW_QUESTION);
+    s.falling.clear();
 }
 
 // Devuelve true si el punto (x, y) está dentro del rectángulo r.
@@ -493,6 +1948,113 @@ static bool rectsOverlap(const SDL_Rect& a, const SDL_Rect& b) {
     return (a.x < b.x + b.w) && (a.x + a.w > b.x) && (a.y < b.y + b.h) && (a.y + a.h > b.y);
 }
 
+// Mueve la paleta un paso a la izquierda (dir < 0) o derecha (dir > 0).
+static void movePaddle(GameSession& s, int dir) {
+    int x = paddleStepX(s.paddle.x, dir);
+    if (x == s.paddle.x) return;
+    s.paddle.x = x;
+    s.paddleTravel += PADDLE_STEP;
+}
+
+// Suelta las letras de la pregunta en pantalla (Continue).
+static void startFalling(GameSession& s) {
+    setState(s, GameState::FALLING);
+    spawnLettersForCurrentQuestion(s);
+}
+
+static bool sessionFinished(const GameSession& s) {
+    return s.state == GameState::GAME_OVER || s.state == GameState::GAME_WIN;
+}
+
+// Con pantalla dividida se sale recién cuando terminaron todos.
+static bool allSessionsFinished() {
+    for (const auto& s : sessions) {
+        if (!sessionFinished(s)) return false;
+    }
+    return true;
+}
+
+// Clic en (mx, my), en coordenadas de la pantalla del jugador.
+static void handleClick(GameSession& s, int mx, int my) {
+    if (s.state == GameState::MODE_SELECT) {
+        if (pointInRect(mx, my, btnModoEstudio)) {
+            selectMode(s, PlayMode::STUDY);
+        } else if (pointInRect(mx, my, btnModoJuego)) {
+            selectMode(s, PlayMode::GAME);
+        }
+    } else if (s.state == GameState::SHOW_QUESTION) {
+        if (pointInRect(mx, my, btnContinue)) startFalling(s);
+    } else if (s.state == GameState::FALLING) {
+        if (pointInRect(mx, my, btnLeft)) {
+            movePaddle(s, -1);
+        } else if (pointInRect(mx, my, btnRight)) {
+            movePaddle(s, 1);
+        }
+    } else if (allSessionsFinished()) {
+        gameRunning = false;
+    }
+}
+
+// Teclas con un solo jugador: las de siempre.
+static void handleSinglePlayerKey(GameSession& s, SDL_Keycode key) {
+    if (s.state == GameState::MODE_SELECT) {
+        if (key == SDLK_1) {
+            selectMode(s, PlayMode::STUDY);
+        } else if (key == SDLK_2) {
+            selectMode(s, PlayMode::GAME);
+        }
+        return;
+    }
+
+    if (s.state == GameState::SHOW_QUESTION) {
+        if (key == SDLK_SPACE || key == SDLK_RETURN) startFalling(s);
+        return;
+    }
+
+    if (s.state == GameState::FALLING) {
+        switch (key) {
+            case SDLK_LEFT:
+            case SDLK_a:
+                movePaddle(s, -1);
+                break;
+            case SDLK_RIGHT:
+            case SDLK_d:
+                movePaddle(s, 1);
+                break;
+            case SDLK_p:
+                setState(s, GameState::SHOW_QUESTION);
+                s.falling.clear();
+                break;
+            default:
+                break;
+        }
+        return;
+    }
+
+    gameRunning = false;
+}
+
+// Teclas de un jugador con pantalla dividida (PLAYER_KEYS). En la selección
+// de modo, izquierda elige JUEGO y derecha ESTUDIO.
+static void handlePlayerKey(GameSession& s, SDL_Keycode key) {
+    const PlayerKeys& k = s.keys;
+    if (s.state == GameState::MODE_SELECT) {
+        if (key == k.left) {
+            selectMode(s, PlayMode::GAME);
+        } else if (key == k.right) {
+            selectMode(s, PlayMode::STUDY);
+        }
+    } else if (s.state == GameState::SHOW_QUESTION) {
+        if (key == k.action) startFalling(s);
+    } else if (s.state == GameState::FALLING) {
+        if (key == k.left) {
+            movePaddle(s, -1);
+        } else if (key == k.right) {
+            movePaddle(s, 1);
+        }
+    }
+}
+
 // Maneja los eventos de entrada del usuario (mouse, teclado) y la lógica de selección de modo.
 static void handleEvents() {
     SDL_Event event;
@@ -508,35 +2070,25 @@ static void handleEvents() {
                 gameRunning = false;
                 break;
 
+            case SDL_WINDOWEVENT:
+                // La ventana perdió su contenido: el camino rápido la repinta entera.
+                if (event.window.event == SDL_WINDOWEVENT_EXPOSED || event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED ||
+                    event.window.event == SDL_WINDOWEVENT_RESTORED) {
+                    swFullRedraw = true;
+                }
+                break;
+
             case SDL_MOUSEBUTTONDOWN:
-                if (event.button.button == SDL_BUTTON_LEFT) {
-                    int mx = event.button.x;
-                    int my = event.button.y;
-
-                    if (state == GameState::MODE_SELECT) {
-                        if (pointInRect(mx, my, btnModoEstudio)) {
-                            playMode = PlayMode::STUDY;
-                            state = GameState::SHOW_QUESTION;
-                        } else if (pointInRect(mx, my, btnModoJuego)) {
-                            playMode = PlayMode::GAME;
-                            // Mensaje por consola antes de mezclar
-                            cout << "[MODO JUEGO] Mezclando preguntas aleatoriamente..." << endl;
-                            std::random_shuffle(questions.begin(), questions.end());
-                            state = GameState::SHOW_QUESTION;
-                        }
-                    } else if (state == GameState::SHOW_QUESTION) {
-                        if (pointInRect(mx, my, btnContinue)) {
-                            state = GameState::FALLING;
-                            spawnLettersForCurrentQuestion();
-                        }
-                    } else if (state == GameState::FALLING) {
-                        if (pointInRect(mx, my, btnLeft)) {
-                            if (paddle.x > 0) paddle.x -= 12;
-                        } else if (pointInRect(mx, my, btnRight)) {
-                            if (paddle.x < W - paddle.w) paddle.x += 12;
+                if (event.button.button == SDL_BUTTON_LEFT && statsLoaded) {
+                    // El clic va al jugador en cuya pantalla cayó.
+                    for (auto& s : sessions) {
+                        const SDL_Rect& v = s.viewport;
+                        int mx = event.button.x - v.x;
+                        int my = event.button.y - v.y;
+                        if (mx >= 0 && mx < v.w && my >= 0 && my < v.h) {
+                            handleClick(s, mx, my);
+                            break;
                         }
-                    } else {
-                        gameRunning = false;
                     }
                 }
                 break;
@@ -546,51 +2098,18 @@ static void handleEvents() {
                     gameRunning = false;
                     break;
                 }
-
-                if (state == GameState::MODE_SELECT) {
-                    if (event.key.keysym.sym == SDLK_1) {
-                        playMode = PlayMode::STUDY;
-                        state = GameState::SHOW_QUESTION;
-                    } else if (event.key.keysym.sym == SDLK_2) {
-                        playMode = PlayMode::GAME;
-                        // Mensaje por consola antes de mezclar
-                        cout << "[MODO JUEGO] Mezclando preguntas aleatoriamente..." << endl;
-                        std::random_shuffle(questions.begin(), questions.end());
-                        state = GameState::SHOW_QUESTION;
-                    }
-                    break;
-                }
-
-                if (state == GameState::SHOW_QUESTION) {
-                    if (event.key.keysym.sym == SDLK_SPACE || event.key.keysym.sym == SDLK_RETURN) {
-                        state = GameState::FALLING;
-                        spawnLettersForCurrentQuestion();
-                    }
-                    break;
-                }
-
-                if (state == GameState::FALLING) {
-                    switch (event.key.keysym.sym) {
-                        case SDLK_LEFT:
-                        case SDLK_a:
-                            if (paddle.x > 0) paddle.x -= 12;
-                            break;
-                        case SDLK_RIGHT:
-                        case SDLK_d:
-                            if (paddle.x < W - paddle.w) paddle.x += 12;
-                            break;
-                        case SDLK_p:
-                            state = GameState::SHOW_QUESTION;
-                            falling.clear();
-                            break;
-                        default:
-                            break;
-                    }
+                if (event.key.keysym.sym == SDLK_F9) {
+                    exportTelemetry();
                     break;
                 }
+                if (!statsLoaded) break; // ver main_loop
 
-                if (state == GameState::GAME_OVER || state == GameState::GAME_WIN) {
+                if (sessions.size() == 1) {
+                    handleSinglePlayerKey(sessions[0], event.key.keysym.sym);
+                } else if (allSessionsFinished()) {
                     gameRunning = false;
+                } else {
+                    for (auto& s : sessions) handlePlayerKey(s, event.key.keysym.sym);
                 }
                 break;
         }
@@ -600,31 +2119,30 @@ static void handleEvents() {
 // Renderiza la pantalla de selección de modo
 // Dibuja la pantalla de selección de modo (juego o estudio).
 static void renderModeSelect() {
-    SDL_SetRenderDrawColor(renderer, BLK.r, BLK.g, BLK.b, BLK.a);
-    SDL_RenderClear(renderer);
     drawText("Selecciona el modo de juego:", W/2 - 180, H/2 - 120, YLW);
     drawButton("MODO JUEGO", btnModoJuego, BLU, BLK);
     drawButton("MODO ESTUDIO", btnModoEstudio, GRN, BLK);
-    drawText("(1) Juego   (2) Estudio", W/2 - 120, H/2 + 40, WHT);
-    SDL_RenderPresent(renderer);
+    if (sessions.size() == 1) drawText("(1) Juego   (2) Estudio", W/2 - 120, H/2 + 40, WHT);
+    else drawText("(izquierda) Juego   (derecha) Estudio", W/2 - 190, H/2 + 40, WHT);
+    if (!statsLoaded) drawText("Cargando estadisticas...", W/2 - 120, H/2 + 80, YLW);
 }
 
 
 // Actualiza la lógica del juego en cada frame (movimiento de letras, colisiones, etc).
-static void updateGame() {
-    if (state != GameState::FALLING) return;
+static void updateGame(GameSession& s) {
+    if (s.state != GameState::FALLING) return;
 
-    for (auto& fl : falling) fl.rect.y += (int)fallSpeed;
+    for (auto& fl : s.falling) fl.rect.y += (int)s.fallSpeed;
 
-    for (const auto& fl : falling) {
-        if (rectsOverlap(fl.rect, paddle)) {
-            handleAnswerCaught(fl);
+    for (const auto& fl : s.falling) {
+        if (rectsOverlap(fl.rect, s.paddle)) {
+            handleAnswerCaught(s, fl);
             return;
         }
     }
 
     bool anyLost = false;
-    for (const auto& fl : falling) {
+    for (const auto& fl : s.falling) {
         if (fl.rect.y > H) {
             anyLost = true;
             break;
@@ -633,26 +2151,28 @@ static void updateGame() {
     if (anyLost) {
         FallingLetter dummy;
         dummy.correct = false;
-        handleAnswerCaught(dummy);
+        handleAnswerCaught(s, dummy);
         return;
     }
 
-    fallSpeed += SPEED_ACCEL; // <- antes 0.01f (más lenta la aceleración)
+    s.fallSpeed += s.fallAccel; // calibrada por cantidad de opciones (quiz.speeds)
 }
 
 // Dibuja la superposición con la pregunta y las opciones antes de que caigan las letras.
-static void renderQuestionOverlay() {
-    if (currentQ < 0 || currentQ >= (int)questions.size()) return;
-    const auto& q = questions[currentQ];
+static void renderQuestionOverlay(const GameSession& s) {
+    if (s.currentIdx < 0 || s.currentIdx >= (int)questions.size()) return;
+    const auto& q = questions[s.currentIdx];
 
-    drawText("PAUSA: lee la pregunta. SPACE/ENTER o Continue para soltar letras.", 18, 14, YLW);
+    char pause[128];
+    const char* action = (sessions.size() == 1) ? "SPACE/ENTER" : s.keys.actionName;
+    SDL_snprintf(pause, sizeof pause, "PAUSA: lee la pregunta. %s o Continue para soltar letras.", action);
+    drawText(pause, 18, 14, YLW);
 
     {
-        ostringstream ss;
-        ss << "Pregunta " << (currentQ + 1) << "/" << questions.size()
-           << " | Aciertos: " << correctCount
-           << " | Para ganar: " << neededToWin();
-        drawText(ss.str(), 18, 44, WHT);
+        char hud[128];
+        SDL_snprintf(hud, sizeof hud, "Pregunta %d/%d | Aciertos: %d | Para ganar: %d",
+                     s.currentQ + 1, (int)questions.size(), s.correctCount, neededToWin());
+        drawText(hud, 18, 44, WHT);
     }
 
     const int leftX = 18;
@@ -662,7 +2182,7 @@ static void renderQuestionOverlay() {
     int y = 90;
 
     // Prompt con wrap por píxeles
-    for (const auto& ln : splitLinesWrapPixels(q.prompt, maxWidth)) {
+    for (const auto& ln : wrappedLines(q.prompt, maxWidth)) {
         drawText(ln, leftX, y, WHT);
         y += lineStep;
     }
@@ -670,12 +2190,12 @@ static void renderQuestionOverlay() {
     y += 10;
 
     // Opciones con wrap por píxeles (y con indent en líneas siguientes)
-    for (const auto& c : questions[currentQ].choices) {
+    for (const auto& c : q.choices) {
         const int indentFirst = 0;
         const int indentNext = 24;
         const string prefix = string(1, c.label) + ") ";
 
-        auto wrapped = splitLinesWrapPixels(prefix + c.text, maxWidth);
+        const auto& wrapped = wrappedLines(prefix + c.text, maxWidth);
         for (size_t i = 0; i < wrapped.size(); i++) {
             int x = leftX + ((i == 0) ? indentFirst : indentNext);
             drawText(wrapped[i], x, y, BLU);
@@ -683,103 +2203,396 @@ static void renderQuestionOverlay() {
         }
     }
 
-    drawButton("Continue (SPACE)", btnContinue, GRN, BLK);
+    char button[48];
+    SDL_snprintf(button, sizeof button, "Continue (%s)", (sessions.size() == 1) ? "SPACE" : s.keys.actionName);
+    drawButton(button, btnContinue, GRN, BLK);
 }
 
 // Dibuja las letras cayendo y la paleta. Colorea en verde la correcta solo en modo estudio.
-static void renderFalling() {
+static void renderFalling(const GameSession& s) {
     drawButton("<--", btnLeft, GRN, BLK);
     drawButton("-->", btnRight, GRN, BLK);
 
     {
-        ostringstream ss;
-        ss << "Pregunta " << (currentQ + 1) << "/" << questions.size()
-           << " | Aciertos: " << correctCount
-           << " | P: Pausa";
-        drawText(ss.str(), 18, 14, WHT);
+        char hud[128];
+        // Con pantalla dividida no hay pausa: se muestran las teclas del jugador.
+        if (sessions.size() == 1) {
+            SDL_snprintf(hud, sizeof hud, "Pregunta %d/%d | Aciertos: %d | P: Pausa",
+                         s.currentQ + 1, (int)questions.size(), s.correctCount);
+        } else {
+            SDL_snprintf(hud, sizeof hud, "Pregunta %d/%d | Aciertos: %d | %s: mover",
+                         s.currentQ + 1, (int)questions.size(), s.correctCount, s.keys.move);
+        }
+        drawText(hud, 18, 14, WHT);
     }
 
-    SDL_SetRenderDrawColor(renderer, WHT.r, WHT.g, WHT.b, WHT.a);
-    SDL_RenderFillRect(renderer, &paddle);
-
-    for (const auto& fl : falling) {
-        SDL_Color box = fl.correct && playMode == PlayMode::STUDY ? SDL_Color{0, 160, 80, 255} : SDL_Color{60, 120, 220, 255};
-        SDL_SetRenderDrawColor(renderer, box.r, box.g, box.b, box.a);
-        SDL_RenderFillRect(renderer, &fl.rect);
+    fillRect(s.paddle, WHT);
 
-        SDL_SetRenderDrawColor(renderer, WHT.r, WHT.g, WHT.b, WHT.a);
-        SDL_RenderDrawRect(renderer, &fl.rect);
-
-        string s(1, fl.label);
-        drawText(s, fl.rect.x + 8, fl.rect.y + 2, WHT);
+    // Primero todas las cajas, después los bordes y las letras: así los
+    // comandos del mismo tipo y color quedan seguidos y se envían juntos.
+    for (const auto& fl : s.falling) {
+        SDL_Color box = fl.correct && s.playMode == PlayMode::STUDY ? SDL_Color{0, 160, 80, 255} : SDL_Color{60, 120, 220, 255};
+        fillRect(fl.rect, box);
     }
+    for (const auto& fl : s.falling) outlineRect(fl.rect, WHT);
+    for (const auto& fl : s.falling) drawText(string(1, fl.label), fl.rect.x + 8, fl.rect.y + 2, WHT);
 }
 
 // Dibuja la pantalla final de victoria o derrota.
-static void renderEndScreen(bool win) {
+static void renderEndScreen(const GameSession& s, bool win) {
     string title = win ? "GANASTE!" : "FIN DEL JUEGO";
     SDL_Color col = win ? GRN : RED;
 
     drawText(title, W / 2 - 90, H / 2 - 80, col);
 
-    ostringstream ss;
-    ss << "Aciertos: " << correctCount << "/" << questions.size()
-       << " | Necesarios: " << neededToWin();
-    drawText(ss.str(), W / 2 - 170, H / 2 - 40, WHT);
+    char summary[128];
+    SDL_snprintf(summary, sizeof summary, "Aciertos: %d/%d | Necesarios: %d",
+                 s.correctCount, (int)questions.size(), neededToWin());
+    drawText(summary, W / 2 - 170, H / 2 - 40, WHT);
 
     drawText("Recarga el juego para reiniciar.", W / 2 - 210, H / 2 + 10, WHT);
 }
 
-// Dibuja la pantalla principal según el estado actual del juego.
-static void renderGame() {
-    SDL_SetRenderDrawColor(renderer, BLK.r, BLK.g, BLK.b, BLK.a);
-    SDL_RenderClear(renderer);
-
-    if (state == GameState::MODE_SELECT) {
+// Dibuja la pantalla de un jugador según su estado.
+static void renderSession(const GameSession& s) {
+    if (s.state == GameState::MODE_SELECT) {
         renderModeSelect();
-        return;
-    }
-    if (questions.empty()) {
+    } else if (questions.empty()) {
         drawText("No se cargaron preguntas. Asegura un archivo quiz.gift valido.", 18, 18, RED);
         drawText("Uso: QuizCatch.exe quiz.gift", 18, 50, WHT);
-        SDL_RenderPresent(renderer);
-        return;
+    } else if (s.state == GameState::SHOW_QUESTION) {
+        renderQuestionOverlay(s);
+    } else if (s.state == GameState::FALLING) {
+        renderFalling(s);
+    } else {
+        renderEndScreen(s, s.state == GameState::GAME_WIN);
+    }
+    // Sesión restaurada antes de que termine de cargar IDBFS: queda en pausa.
+    if (!statsLoaded && s.state != GameState::MODE_SELECT) drawText("Cargando estadisticas...", W/2 - 120, H/2 + 80, YLW);
+
+    // Pantalla dividida: borde y teclas de cada jugador.
+    if (sessions.size() > 1) {
+        char label[96];
+        SDL_snprintf(label, sizeof label, "Jugador %d: %s mover, %s seguir", s.player + 1, s.keys.move, s.keys.actionName);
+        drawText(label, 18, H - BUTTON_HEIGHT - 48, YLW);
+        outlineRect({0, 0, W, H}, YLW);
     }
-    if (state == GameState::SHOW_QUESTION) renderQuestionOverlay();
-    else if (state == GameState::FALLING) renderFalling();
-    else if (state == GameState::GAME_OVER) renderEndScreen(false);
-    else if (state == GameState::GAME_WIN) renderEndScreen(true);
-    SDL_RenderPresent(renderer);
+}
+
+// Dibuja todas las pantallas en la misma ventana y las presenta juntas: la
+// fuente, el caché de textos y el envío de comandos son compartidos.
+static void renderGame() {
+    clearScreen(BLK);
+    for (const auto& s : sessions) {
+        setDrawViewport(s.viewport);
+        renderSession(s);
+    }
+    presentFrame();
 }
 
 
+// Memoria del proceso en KB, o -1 si no se puede medir. En la web es el
+// tamaño del heap de wasm (crece y no se devuelve); en Linux, la memoria
+// residente de /proc/self/statm, que incluye lo que reservan SDL y el driver.
+#ifdef __EMSCRIPTEN__
+static const char* const MEMORY_KIND = "heap wasm";
+#else
+static const char* const MEMORY_KIND = "residente";
+#endif
+static long processMemoryKB() {
+#ifdef __EMSCRIPTEN__
+    return EM_ASM_INT({ return HEAPU8.length; }) / 1024;
+#elif defined(__linux__)
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return -1;
+    long pages = 0, resident = -1;
+    if (fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = -1;
+    fclose(f);
+    return resident < 0 ? -1 : resident * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+    return -1;
+#endif
+}
+
+// Informa una sola vez cuánto tardó en quedar interactiva la pantalla inicial
+// (en la web, desde que el navegador empezó a cargar la página).
+static void reportTimeToInteractive() {
+    static bool reported = false;
+    if (reported || !statsLoaded) return;
+    reported = true;
+#ifdef __EMSCRIPTEN__
+    double ms = EM_ASM_DOUBLE({ return performance.now(); });
+#else
+    double ms = (double)SDL_GetTicks();
+#endif
+    SDL_Log("[TTI] %d ms", (int)ms);
+    long kb = processMemoryKB();
+    if (kb >= 0) SDL_Log("[MEM] %s %ld KB con %d jugador(es)", MEMORY_KIND, kb, (int)sessions.size());
+}
+
 // Add this new function for the loop
 // Loop principal: procesa eventos, actualiza lógica y renderiza.
 static void main_loop() {
     Uint32 frameStart = SDL_GetTicks();
+    if (!statsLoaded && persistenceReady()) {
+        loadStats();
+        // Sesión restaurada en modo juego: el planificador necesita las estadísticas.
+        const GameSession& s = sessions[0];
+        if (s.playMode == PlayMode::GAME && s.state != GameState::MODE_SELECT && s.order.empty()) schedBuild();
+    }
     handleEvents();
-    updateGame();
+    // Como en selectMode: sin estadísticas una respuesta se perdería (loadStats
+    // las pisa) y el planificador estaría vacío. Solo una sesión restaurada
+    // puede estar jugando antes de que carguen; queda quieta hasta entonces.
+    if (statsLoaded) {
+        for (auto& s : sessions) updateGame(s);
+    }
     renderGame();
+    reportTimeToInteractive();
+    flushTelemetry(false);
+    // La sesión en curso se guarda solo con un jugador (ver restoreSession).
+    const GameSession& s = sessions[0];
+    if (sessions.size() == 1 &&
+        (snapshotDirty || (s.state == GameState::FALLING && SDL_GetTicks() - lastSnapshotTicks >= SNAPSHOT_FALLING_MS))) {
+        saveSnapshot();
+    }
     Uint32 frameTime = SDL_GetTicks() - frameStart;
     // No SDL_Delay needed in web; Emscripten handles framing
 }
 
+#ifndef __EMSCRIPTEN__
+// Pone a todos los jugadores en 'screen', cada uno con otra pregunta.
+static void benchSetup(GameState screen) {
+    for (auto& s : sessions) {
+        s.state = screen;
+        s.currentIdx = s.player % (int)questions.size();
+        spawnLettersForCurrentQuestion(s);
+    }
+    swFullRedraw = true;
+}
+
+// Un frame del bench. En FALLING simula la caída y la paleta sin pasar por
+// updateGame(), para no tocar estadísticas ni telemetría.
+static void benchFrame(int i) {
+    for (auto& s : sessions) {
+        if (s.state != GameState::FALLING) continue;
+        for (auto& fl : s.falling) fl.rect.y += INITIAL_SPEED;
+        if (!s.falling.empty() && s.falling[0].rect.y > s.paddle.y) spawnLettersForCurrentQuestion(s);
+        if ((i + s.player) % 4 == 0) s.paddle.x = (s.paddle.x + 12) % (W - s.paddle.w);
+    }
+    renderGame();
+}
+
+// Frames por segundo dibujando una pantalla.
+static double benchScreenFps(GameState screen, int frames) {
+    benchSetup(screen);
+    swUploadedPixels = 0;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < frames; i++) benchFrame(i);
+    double secs = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    return secs > 0 ? frames / secs : 0.0;
+}
+
+// Milisegundos por frame en 'screen', sin contar el primero (llena el caché
+// de textos). Deja en drawCalls las llamadas a SDL de esos frames.
+static double benchFrameMs(GameState screen, int frames) {
+    benchSetup(screen);
+    benchFrame(0);
+    drawCalls = 0;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 1; i <= frames; i++) benchFrame(i);
+    double secs = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    return secs * 1000.0 / frames;
+}
+
+// Memoria de una ejecución aparte del juego con 'players' jugadores: corre
+// este mismo programa con --bench-memory, que dibuja las dos pantallas y
+// escribe cuánta memoria residente usó. Cada proceso empieza de cero, así que
+// se compara de verdad la ventana compartida con N procesos de un jugador.
+#ifdef __linux__
+static long childMemoryKB(const string& giftPath, int players, bool fast, int frames) {
+    char exe[1024];
+    ssize_t len = readlink("/proc/self/exe", exe, sizeof exe - 1);
+    if (len <= 0) return -1;
+    exe[len] = '\0';
+    char cmd[2048];
+    SDL_snprintf(cmd, sizeof cmd, "'%s' '%s' --bench-memory %d --bench %d%s 2>/dev/null",
+                 exe, giftPath.c_str(), players, frames, fast ? "" : " --no-fastpath");
+    FILE* p = popen(cmd, "r");
+    if (!p) return -1;
+    long kb = -1;
+    char line[256];
+    while (fgets(line, sizeof line, p)) sscanf(line, "[BENCH-MEMORY] %ld", &kb);
+    pclose(p);
+    return kb;
+}
+#else
+static long childMemoryKB(const string&, int, bool, int) { return -1; } // solo en Linux
+#endif
+
+// --bench-memory P: lo lanza childMemoryKB. Con la ventana ya creada para P
+// jugadores dibuja las dos pantallas y escribe la memoria residente en KB
+// por la salida estándar.
+static void runMemoryBench(int frames) {
+    long kb = -1;
+    if (!questions.empty() && font) {
+        initGameUI();
+        benchFrameMs(GameState::SHOW_QUESTION, frames);
+        benchFrameMs(GameState::FALLING, frames);
+        kb = processMemoryKB();
+    }
+    printf("[BENCH-MEMORY] %ld\n", kb);
+}
+
+// Ventana del tamaño de la grilla actual. El renderer se crea de nuevo porque
+// el de software toma la superficie de la ventana al crearse.
+static bool resizeBenchWindow() {
+    shutdownSoftwareFastPath();
+    SDL_DestroyRenderer(renderer);
+    SDL_SetWindowSize(window, winW, winH);
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+    return renderer != nullptr;
+}
+
+// Pantalla dividida: cómo crecen el tiempo por frame, las llamadas de dibujo
+// y la memoria de 1 a MAX_PLAYERS jugadores, comparado con otros tantos
+// procesos del juego con un jugador cada uno.
+static void runPlayersBench(int frames, const string& giftPath) {
+    const char* paths[] = {"directo", "regiones"};
+    for (int fast = 0; fast < 2; fast++) {
+        double ms1 = 0.0;
+        long kb1 = -1;
+        for (int players = 1; players <= MAX_PLAYERS; players++) {
+            layoutSessions(players);
+            initGameUI();
+            if (!resizeBenchWindow()) {
+                SDL_Log("[BENCH] Error renderer: %s", SDL_GetError());
+                return;
+            }
+            if (fast) {
+                initSoftwareFastPath();
+                if (!swFastPath) return;
+            }
+            double questionMs = benchFrameMs(GameState::SHOW_QUESTION, frames);
+            double fallingMs = benchFrameMs(GameState::FALLING, frames);
+            double calls = (double)drawCalls / frames;
+
+            long kb = childMemoryKB(giftPath, players, fast != 0, frames);
+            if (players == 1) {
+                ms1 = fallingMs;
+                kb1 = kb;
+            }
+            char memory[96] = "memoria no disponible (solo Linux)";
+            if (kb >= 0 && kb1 > 0) {
+                SDL_snprintf(memory, sizeof memory, "residente %ld KB (x%.2f; %d procesos: %ld KB)",
+                             kb, (double)kb / kb1, players, players * kb1);
+            }
+            SDL_Log("[BENCH] %-8s %d jug | pregunta %6.3f ms | caida %6.3f ms (x%.2f) %5.1f llamadas | %s",
+                    paths[fast], players, questionMs, fallingMs, ms1 > 0 ? fallingMs / ms1 : 0.0, calls, memory);
+        }
+    }
+    SDL_Log("[BENCH] x = veces el valor con 1 jugador; memoria residente de un proceso aparte por fila"
+            " (juego, SDL y driver), contra N procesos de 1 jugador");
+}
+
+// --bench [N]: compara el dibujo original, el de lotes y el camino rápido por
+// software, y después mide la pantalla dividida.
+// Corre sin ventana con el driver de video "dummy" de SDL.
+static void runRenderBench(int frames, const string& giftPath) {
+    if (questions.empty() || !font) {
+        SDL_Log("[BENCH] Hacen falta preguntas y la fuente arial.ttf");
+        return;
+    }
+    initGameUI();
+    const GameState screens[] = {GameState::SHOW_QUESTION, GameState::FALLING};
+    for (GameState screen : screens) {
+        shutdownSoftwareFastPath();
+        uncachedDraw = true;
+        double original = benchScreenFps(screen, frames);
+        uncachedDraw = false;
+        double batched = benchScreenFps(screen, frames);
+
+        allowFastPath = true;
+        initSoftwareFastPath();
+        if (!swFastPath) {
+            SDL_Log("[BENCH] El renderer no es por software: no hay camino rapido para comparar");
+            return;
+        }
+        double fast = benchScreenFps(screen, frames);
+        double uploaded = 100.0 * swUploadedPixels / ((double)frames * winW * winH);
+
+        SDL_Log("[BENCH] %-13s original %7.0f fps | lotes %7.0f fps | rapido %7.0f fps (x%.1f) | subido %.1f%% de la pantalla por frame",
+                TELEMETRY_STATE_NAMES[(int)screen], original, batched, fast, original > 0 ? fast / original : 0.0, uploaded);
+    }
+    runPlayersBench(frames, giftPath);
+}
+#endif
+
 // Función principal: inicializa, carga preguntas, entra al loop principal y limpia al salir.
 int main(int argc, char* argv[]) {
+    string giftPath = "quiz.gift";  // Preload this file
+    int benchFrames = 0;
+#ifndef __EMSCRIPTEN__
+    bool benchMemory = false;
+#endif
+    int players = 1;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--software") forceSoftware = true;
+        else if (arg == "--players" && i + 1 < argc) players = atoi(argv[++i]);
+#ifndef __EMSCRIPTEN__
+        else if (arg == "--bench-memory" && i + 1 < argc) {
+            benchMemory = true;
+            players = atoi(argv[++i]);
+        }
+#endif
+        else if (arg == "--no-fastpath") allowFastPath = false;
+        else if (arg == "--bench") benchFrames = (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) ? atoi(argv[++i]) : 600;
+        else giftPath = arg;
+    }
+    if (benchFrames > 0) {
+        forceSoftware = true;
+        if (!SDL_getenv("SDL_VIDEODRIVER")) SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    }
+#ifdef __EMSCRIPTEN__
+    // En la web la cantidad de jugadores va en la URL: quiz.html?players=2
+    players = EM_ASM_INT({
+        var m = /[?&]players=(\d+)/.exec(location.search);
+        return m ? parseInt(m[1], 10) : 1;
+    });
+#endif
+    layoutSessions(players); // antes de crear la ventana: define su tamaño
+
     SDL_SetMainReady();
     if (!initSDL()) return 1;
 
     // Change font path for web (preload "arial.ttf")
     font = TTF_OpenFont("arial.ttf", 22);  // Remove Windows path fallback if not needed
 
-    string giftPath = "quiz.gift";  // Preload this file
-    if (argc >= 2) giftPath = argv[1];
     questions = parseGiftSimple(readAllFile(giftPath));
-
-    initGameUI();
-    state = GameState::MODE_SELECT; // Mostrar pantalla de selección de modo al inicio
-    currentQ = 0;
-    correctCount = 0;
+    loadSpeedTable(readAllFile(SPEED_TABLE_PATH));
+#ifndef __EMSCRIPTEN__
+    if (benchFrames > 0) {
+        if (benchMemory) runMemoryBench(benchFrames);
+        else runRenderBench(benchFrames, giftPath);
+        cleanup();
+        return 0;
+    }
+#endif
+    bankHash = fnv1a(string());
+    for (const auto& q : questions) bankHash = fnv1a(reinterpret_cast<const unsigned char*>(&q.stats.id), sizeof q.stats.id, bankHash);
+    initPersistence();
+
+    TelemetryEvent session;
+    session.type = TEV_SESSION;
+    session.questionId = (uint64_t)time(nullptr);
+    session.label = (uint8_t)sessions.size();
+    logEvent(session, sessions[0]);
+
+    initGameUI(); // cada sesión empieza en la selección de modo
+    if (sessions.size() == 1) restoreSession(); // si se recargó la página a mitad de partida, sigue donde estaba
 
     /*
     +---------------------------+
@@ -0,0 +1,213 @@
+/*
+========================================
+ QUIZTELEMETRY: registro de telemetría -> CSV
+========================================
+
+Convierte el registro binario que exporta el juego (quiz.telemetry.export,
+formato en telemetry.h) a CSV y muestra estadísticas agregadas por consola.
+
+El juego guarda el registro en segmentos (quiz.telemetry.0, .1, ...) y los une
+en quiz.telemetry.export al exportar: F9 en la web (lo descarga el navegador) o
+al salir en escritorio. Un segmento suelto también se puede convertir.
+
+Compilar (escritorio, no necesita SDL):
+
+g++ quiztelemetry.cpp -o quiztelemetry -std=c++11 -O2
+
+Uso:
+
+quiztelemetry quiz.telemetry.export eventos.csv [preguntas.csv]
+
+- eventos.csv   → un renglón por evento (sesiones, cambios de estado, respuestas);
+                  la columna player es el jugador (0 a 3) con pantalla dividida
+- preguntas.csv → opcional: respuestas, aciertos y tiempos por pregunta
+
+*/
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "telemetry.h"
+
+using namespace std;
+
+struct QuestionAgg {
+    uint32_t answers = 0;
+    uint32_t hits = 0;
+    uint32_t lost = 0;
+    uint64_t answerMsSum = 0;
+    uint64_t travelSum = 0;
+};
+
+struct PlayerAgg {
+    uint32_t answers = 0;
+    uint32_t hits = 0;
+};
+
+static const char* typeName(uint8_t t) {
+    switch (t) {
+        case TEV_SESSION: return "SESSION";
+        case TEV_STATE: return "STATE";
+        case TEV_ANSWER: return "ANSWER";
+        case TEV_DROPPED: return "DROPPED";
+        default: return "UNKNOWN";
+    }
+}
+
+static const char* stateName(uint8_t s) {
+    const size_t n = sizeof(TELEMETRY_STATE_NAMES) / sizeof(TELEMETRY_STATE_NAMES[0]);
+    return (s < n) ? TELEMETRY_STATE_NAMES[s] : "?";
+}
+
+// Percentil p (0..100) de un vector ya ordenado.
+static uint32_t percentile(const vector<uint32_t>& sorted, int p) {
+    if (sorted.empty()) return 0;
+    size_t i = (sorted.size() - 1) * (size_t)p / 100;
+    return sorted[i];
+}
+
+// Lee el registro completo. Devuelve false si no existe o no es un registro válido.
+static bool readLog(const char* path, vector<TelemetryEvent>& events) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "No se pudo abrir %s\n", path);
+        return false;
+    }
+
+    unsigned char header[TELEMETRY_HEADER_SIZE];
+    uint32_t version = 0;
+    bool ok = fread(header, 1, sizeof header, f) == sizeof header &&
+              memcmp(header, TELEMETRY_MAGIC, sizeof TELEMETRY_MAGIC) == 0;
+    if (ok) {
+        version = (uint32_t)header[4] | ((uint32_t)header[5] << 8) |
+                  ((uint32_t)header[6] << 16) | ((uint32_t)header[7] << 24);
+        ok = (version == TELEMETRY_VERSION);
+    }
+    if (!ok) {
+        fprintf(stderr, "%s no es un registro de telemetria valido (version %u)\n", path, version);
+        fclose(f);
+        return false;
+    }
+
+    TelemetryEvent batch[256];
+    size_t n;
+    while ((n = fread(batch, sizeof(TelemetryEvent), 256, f)) > 0) {
+        events.insert(events.end(), batch, batch + n);
+    }
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Uso: %s quiz.telemetry.export eventos.csv [preguntas.csv]\n", argv[0]);
+        return 1;
+    }
+
+    vector<TelemetryEvent> events;
+    if (!readLog(argv[1], events)) return 1;
+
+    FILE* out = fopen(argv[2], "w");
+    if (!out) {
+        fprintf(stderr, "No se pudo crear %s\n", argv[2]);
+        return 1;
+    }
+    fprintf(out, "session,player,time_ms,type,from_state,to_state,question_num,question_id,"
+                 "label,correct,answer_ms,paddle_travel,fall_speed\n");
+
+    uint32_t sessions = 0;
+    uint32_t dropped = 0;
+    uint32_t answers = 0;
+    uint32_t hits = 0;
+    uint32_t lost = 0;
+    uint64_t travelSum = 0;
+    double speedSum = 0.0;
+    vector<uint32_t> answerMs;
+    map<uint64_t, QuestionAgg> perQuestion;
+    map<int, PlayerAgg> perPlayer;
+
+    for (const auto& ev : events) {
+        if (ev.type == TEV_SESSION) sessions++;
+
+        bool isState = (ev.type == TEV_STATE);
+        bool isAnswer = (ev.type == TEV_ANSWER);
+        char label[2] = {isAnswer ? (char)ev.label : '\0', '\0'};
+
+        fprintf(out, "%u,%u,%u,%s,%s,%s,%u,%016" PRIx64 ",%s,%s,%s,%s,",
+                sessions, ev.player, ev.timeMs, typeName(ev.type),
+                isState ? stateName(ev.fromState) : "",
+                isState ? stateName(ev.toState) : "",
+                ev.questionNum, ev.questionId, label,
+                isAnswer ? (ev.correct ? "1" : "0") : "",
+                isAnswer ? to_string(ev.answerMs).c_str() : "",
+                isAnswer ? to_string(ev.paddleTravel).c_str() : "");
+        if (isAnswer) fprintf(out, "%.3f\n", ev.fallSpeed);
+        else fprintf(out, "\n");
+
+        if (ev.type == TEV_DROPPED) dropped += ev.answerMs;
+        if (!isAnswer) continue;
+
+        answers++;
+        if (ev.correct) hits++;
+        if (ev.label == '?') lost++;
+        travelSum += ev.paddleTravel;
+        speedSum += ev.fallSpeed;
+        answerMs.push_back(ev.answerMs);
+
+        PlayerAgg& p = perPlayer[ev.player];
+        p.answers++;
+        if (ev.correct) p.hits++;
+
+        QuestionAgg& q = perQuestion[ev.questionId];
+        q.answers++;
+        if (ev.correct) q.hits++;
+        if (ev.label == '?') q.lost++;
+        q.answerMsSum += ev.answerMs;
+        q.travelSum += ev.paddleTravel;
+    }
+    fclose(out);
+
+    sort(answerMs.begin(), answerMs.end());
+    double denom = answers ? (double)answers : 1.0;
+
+    printf("Eventos:            %zu\n", events.size());
+    printf("Sesiones:           %u\n", sessions);
+    printf("Eventos perdidos:   %u\n", dropped);
+    printf("Respuestas:         %u\n", answers);
+    printf("Aciertos:           %u (%.1f%%)\n", hits, 100.0 * hits / denom);
+    printf("Letras perdidas:    %u\n", lost);
+    printf("Tiempo de caida ms: p50 %u | p90 %u | max %u\n",
+           percentile(answerMs, 50), percentile(answerMs, 90), percentile(answerMs, 100));
+    printf("Recorrido paleta:   %.1f px en promedio\n", travelSum / denom);
+    printf("Velocidad al atrapar: %.2f px/frame en promedio\n", speedSum / denom);
+    printf("Preguntas distintas: %zu\n", perQuestion.size());
+    if (perPlayer.size() > 1) {
+        for (const auto& kv : perPlayer) {
+            printf("Jugador %d:          %u respuestas, %u aciertos (%.1f%%)\n", kv.first + 1, kv.second.answers,
+                   kv.second.hits, 100.0 * kv.second.hits / kv.second.answers);
+        }
+    }
+
+    if (argc >= 4) {
+        FILE* qf = fopen(argv[3], "w");
+        if (!qf) {
+            fprintf(stderr, "No se pudo crear %s\n", argv[3]);
+            return 1;
+        }
+        fprintf(qf, "question_id,answers,hits,accuracy,lost,avg_answer_ms,avg_paddle_travel\n");
+        for (const auto& kv : perQuestion) {
+            const QuestionAgg& q = kv.second;
+            fprintf(qf, "%016" PRIx64 ",%u,%u,%.3f,%u,%.0f,%.1f\n",
+                    kv.first, q.answers, q.hits, (double)q.hits / q.answers, q.lost,
+                    (double)q.answerMsSum / q.answers, (double)q.travelSum / q.answers);
+        }
+        fclose(qf);
+    }
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+/*
+========================================
+ TELEMETRÍA DE RESPUESTAS
+========================================
+
+Formato del registro binario que escribe quizcatch.cpp (los segmentos
+quiz.telemetry.N y su exportación quiz.telemetry.export) y que lee la
+herramienta quiztelemetry.cpp para convertirlo a CSV.
+
+Archivo:
+  - Cabecera de 8 bytes: "QCTL" + versión (uint32, little endian)
+  - Eventos de 32 bytes (TelemetryEvent) uno detrás de otro.
+    Cada ejecución del juego empieza con un evento TEV_SESSION.
+
+El juego no escribe al disco en cada respuesta: los eventos van a un buffer
+circular sin locks (TelemetryRing) y se vuelcan en lotes en frames ociosos.
+*/
+
+#ifndef QUIZ_TELEMETRY_H
+#define QUIZ_TELEMETRY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+static const char TELEMETRY_MAGIC[4] = {'Q', 'C', 'T', 'L'};
+static const uint32_t TELEMETRY_VERSION = 1;
+static const size_t TELEMETRY_HEADER_SIZE = 8;
+
+enum TelemetryEventType : uint8_t {
+    TEV_SESSION = 1, // inicio de ejecución: questionId = hora Unix de inicio, label = jugadores
+    TEV_STATE = 2,   // cambio de estado: fromState -> toState
+    TEV_ANSWER = 3,  // letra atrapada (o perdida, label = '?')
+    TEV_DROPPED = 4  // eventos descartados por buffer lleno: answerMs = cantidad
+};
+
+// Mismo orden que GameState en quizcatch.cpp.
+static const char* const TELEMETRY_STATE_NAMES[] = {
+    "MODE_SELECT", "SHOW_QUESTION", "FALLING", "GAME_OVER", "GAME_WIN"
+};
+
+// Evento de tamaño fijo; se escribe tal cual (wasm y x86 son little endian).
+struct TelemetryEvent {
+    uint32_t timeMs = 0;       // SDL_GetTicks() al registrarlo
+    uint8_t type = 0;          // TelemetryEventType
+    uint8_t fromState = 0;
+    uint8_t toState = 0;
+    uint8_t label = 0;         // letra elegida
+    uint64_t questionId = 0;   // hash de la pregunta (el mismo de quiz.stats)
+    uint32_t answerMs = 0;     // desde Continue hasta atrapar la letra
+    uint16_t paddleTravel = 0; // píxeles recorridos por la paleta durante la caída
+    uint8_t correct = 0;
+    uint8_t player = 0;        // jugador (0 a 3) con pantalla dividida; 0 con uno solo
+    float fallSpeed = 0.0f;    // velocidad de caída al atrapar
+    uint32_t questionNum = 0;  // preguntas ya respondidas en la sesión
+};
+
+static_assert(sizeof(TelemetryEvent) == 32, "TelemetryEvent debe medir 32 bytes");
+
+// Buffer circular de un productor y un consumidor, sin locks.
+// push() nunca bloquea: si está lleno descarta el evento y lo cuenta.
+template <uint32_t N>
+class TelemetryRing {
+    static_assert((N & (N - 1)) == 0, "N debe ser potencia de 2");
+
+public:
+    bool push(const TelemetryEvent& ev) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t t = tail.load(std::memory_order_acquire);
+        if (h - t == N) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        buf[h & (N - 1)] = ev;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Copia hasta 'max' eventos a 'out' y los libera. Devuelve cuántos copió.
+    uint32_t pop(TelemetryEvent* out, uint32_t max) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        uint32_t h = head.load(std::memory_order_acquire);
+        uint32_t n = (h - t < max) ? h - t : max;
+        for (uint32_t i = 0; i < n; i++) out[i] = buf[(t + i) & (N - 1)];
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    uint32_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    uint32_t takeDropped() { return dropped.exchange(0, std::memory_order_relaxed); }
+
+    static uint32_t capacity() { return N; }
+
+private:
+    TelemetryEvent buf[N];
+    std::atomic<uint32_t> head{0};
+    std::atomic<uint32_t> tail{0};
+    std::atomic<uint32_t> dropped{0};
+};
+
+#endif
@@ -0,0 +1,341 @@
+/*
+========================================
+ WASMSIZE: tamaño de la versión web y presupuesto
+========================================
+
+Lee quiz.wasm y muestra cuánto ocupa cada sección y cuáles son las funciones
+más grandes. Si se le pasan límites (--budget-*), compara contra ellos wasm, js,
+data y el tiempo hasta quedar interactivo; si algo los supera, termina con
+código 1 para que un script de publicación pueda frenar. No hay límites por
+defecto: los fija quien publica, con los números de un build liviano medido.
+
+Los nombres de funciones salen de la sección "name" del wasm, que solo tiene
+el build de análisis (--profiling-funcs, ver los perfiles en quizcatch.cpp).
+Sin ella las funciones aparecen como func[N]. El presupuesto del wasm no cuenta
+esa sección: se publica el build sin nombres.
+
+Compilar (escritorio, no necesita SDL):
+
+g++ wasmsize.cpp -o wasmsize -std=c++11 -O2
+
+Uso:
+
+wasmsize quiz.wasm [--top N] [--js quiz.js] [--data quiz.data]
+         [--budget-wasm KB] [--budget-js KB] [--budget-data KB]
+         [--tti MS] [--budget-tti MS]
+
+--tti es el valor que el juego escribe en la consola del navegador como
+"[TTI] N ms" al mostrar la primera pantalla interactiva.
+
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct Section {
+    string name;
+    uint64_t size = 0;
+};
+
+struct Function {
+    uint32_t index = 0;
+    uint64_t size = 0;
+};
+
+// Lector de enteros LEB128 sobre un buffer; marca 'ok = false' si se pasa del final.
+struct Reader {
+    const vector<unsigned char>& b;
+    size_t pos;
+    size_t end;
+    bool ok = true;
+
+    Reader(const vector<unsigned char>& buf, size_t p, size_t e) : b(buf), pos(p), end(e) {}
+
+    uint64_t leb() {
+        uint64_t v = 0;
+        int shift = 0;
+        while (ok) {
+            if (pos >= end || shift > 63) {
+                ok = false;
+                break;
+            }
+            unsigned char c = b[pos++];
+            v |= (uint64_t)(c & 0x7f) << shift;
+            shift += 7;
+            if (!(c & 0x80)) break;
+        }
+        return v;
+    }
+
+    unsigned char byte() {
+        if (pos >= end) {
+            ok = false;
+            return 0;
+        }
+        return b[pos++];
+    }
+
+    string str() {
+        uint64_t n = leb();
+        if (!ok || n > end - pos) {
+            ok = false;
+            return {};
+        }
+        string s(reinterpret_cast<const char*>(&b[pos]), (size_t)n);
+        pos += (size_t)n;
+        return s;
+    }
+
+    void skip(uint64_t n) {
+        if (n > end - pos) ok = false;
+        else pos += (size_t)n;
+    }
+};
+
+static bool readFile(const string& path, vector<unsigned char>& out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    unsigned char buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof buf, f)) > 0) out.insert(out.end(), buf, buf + n);
+    fclose(f);
+    return true;
+}
+
+static long long fileSize(const string& path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return -1;
+    fseek(f, 0, SEEK_END);
+    long long n = ftell(f);
+    fclose(f);
+    return n;
+}
+
+static const char* sectionName(unsigned id) {
+    static const char* names[] = {"custom", "type", "import", "function", "table", "memory", "global",
+                                  "export", "start", "element", "code", "data", "datacount", "tag"};
+    return id < sizeof(names) / sizeof(names[0]) ? names[id] : "?";
+}
+
+// Cuenta las funciones importadas: el índice de las funciones propias empieza después.
+static uint32_t countFunctionImports(Reader r) {
+    uint32_t funcs = 0;
+    uint64_t n = r.leb();
+    for (uint64_t i = 0; i < n && r.ok; i++) {
+        r.str();
+        r.str();
+        unsigned char kind = r.byte();
+        switch (kind) {
+            case 0: // función
+                r.leb();
+                funcs++;
+                break;
+            case 1: { // tabla
+                r.byte();
+                unsigned char flags = r.byte();
+                r.leb();
+                if (flags & 1) r.leb();
+                break;
+            }
+            case 2: { // memoria
+                unsigned char flags = r.byte();
+                r.leb();
+                if (flags & 1) r.leb();
+                break;
+            }
+            case 3: // global
+                r.byte();
+                r.byte();
+                break;
+            case 4: // tag
+                r.byte();
+                r.leb();
+                break;
+            default:
+                return funcs;
+        }
+    }
+    return funcs;
+}
+
+// Lee la subsección de nombres de funciones de la sección "name".
+static void readFunctionNames(Reader r, map<uint32_t, string>& names) {
+    while (r.ok && r.pos < r.end) {
+        unsigned char id = r.byte();
+        uint64_t size = r.leb();
+        if (!r.ok) return;
+        if (id != 1) {
+            r.skip(size);
+            continue;
+        }
+        Reader sub(r.b, r.pos, r.pos + (size_t)size);
+        uint64_t n = sub.leb();
+        for (uint64_t i = 0; i < n && sub.ok; i++) {
+            uint32_t idx = (uint32_t)sub.leb();
+            string name = sub.str();
+            if (sub.ok) names[idx] = name;
+        }
+        return;
+    }
+}
+
+static string kb(double bytes) {
+    char buf[32];
+    snprintf(buf, sizeof buf, "%.1f KB", bytes / 1024.0);
+    return buf;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Uso: %s quiz.wasm [--top N] [--js quiz.js] [--data quiz.data]\n"
+            "       [--budget-wasm KB] [--budget-js KB] [--budget-data KB] [--tti MS] [--budget-tti MS]\n",
+            prog);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    string wasmPath = argv[1];
+    string base = wasmPath;
+    if (base.size() > 5 && base.compare(base.size() - 5, 5, ".wasm") == 0) base.resize(base.size() - 5);
+    string jsPath = base + ".js";
+    string dataPath = base + ".data";
+    int top = 25;
+    double budgetWasm = -1, budgetJs = -1, budgetData = -1, budgetTti = -1; // -1: sin límite
+    double tti = -1;
+
+    for (int i = 2; i < argc; i++) {
+        string a = argv[i];
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 2;
+        }
+        const char* v = argv[++i];
+        if (a == "--top") top = atoi(v);
+        else if (a == "--js") jsPath = v;
+        else if (a == "--data") dataPath = v;
+        else if (a == "--budget-wasm") budgetWasm = atof(v);
+        else if (a == "--budget-js") budgetJs = atof(v);
+        else if (a == "--budget-data") budgetData = atof(v);
+        else if (a == "--tti") tti = atof(v);
+        else if (a == "--budget-tti") budgetTti = atof(v);
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    vector<unsigned char> wasm;
+    if (!readFile(wasmPath, wasm) || wasm.size() < 8 || memcmp(wasm.data(), "\0asm", 4) != 0) {
+        fprintf(stderr, "%s no es un archivo wasm\n", wasmPath.c_str());
+        return 2;
+    }
+
+    vector<Section> sections;
+    vector<Function> functions;
+    map<uint32_t, string> names;
+    uint32_t importedFuncs = 0;
+    uint64_t nameBytes = 0; // sección "name": solo en el build de análisis
+    size_t codeStart = 0, codeEnd = 0;
+
+    Reader r(wasm, 8, wasm.size());
+    while (r.ok && r.pos < r.end) {
+        unsigned id = r.byte();
+        uint64_t size = r.leb();
+        if (!r.ok || size > r.end - r.pos) {
+            fprintf(stderr, "%s: seccion truncada\n", wasmPath.c_str());
+            return 2;
+        }
+        size_t start = r.pos;
+        size_t end = start + (size_t)size;
+
+        Section s;
+        s.name = sectionName(id);
+        s.size = size;
+        if (id == 0) {
+            Reader c(wasm, start, end);
+            string custom = c.str();
+            s.name = "custom:" + custom;
+            if (custom == "name") {
+                readFunctionNames(Reader(wasm, c.pos, end), names);
+                nameBytes = size;
+            }
+        } else if (id == 2) {
+            importedFuncs = countFunctionImports(Reader(wasm, start, end));
+        } else if (id == 10) {
+            codeStart = start;
+            codeEnd = end;
+        }
+        sections.push_back(s);
+        r.pos = end;
+    }
+
+    // El cuerpo de cada función: tamaño LEB seguido del código.
+    if (codeEnd > codeStart) {
+        Reader c(wasm, codeStart, codeEnd);
+        uint64_t n = c.leb();
+        for (uint64_t i = 0; i < n && c.ok; i++) {
+            Function f;
+            f.index = importedFuncs + (uint32_t)i;
+            f.size = c.leb();
+            c.skip(f.size);
+            if (c.ok) functions.push_back(f);
+        }
+    }
+
+    double total = (double)wasm.size();
+    printf("%s: %s\n\nSecciones:\n", wasmPath.c_str(), kb(total).c_str());
+    sort(sections.begin(), sections.end(), [](const Section& a, const Section& b) { return a.size > b.size; });
+    for (const auto& s : sections) {
+        printf("  %-24s %12s %6.1f%%\n", s.name.c_str(), kb((double)s.size).c_str(), 100.0 * s.size / total);
+    }
+
+    sort(functions.begin(), functions.end(), [](const Function& a, const Function& b) { return a.size > b.size; });
+    printf("\nFunciones mas grandes (%zu en total%s):\n", functions.size(),
+           names.empty() ? ", sin nombres: compilar con --profiling-funcs" : "");
+    for (int i = 0; i < top && i < (int)functions.size(); i++) {
+        const Function& f = functions[i];
+        auto it = names.find(f.index);
+        string name = (it != names.end()) ? it->second : "func[" + to_string(f.index) + "]";
+        printf("  %10llu B %6.1f%%  %s\n", (unsigned long long)f.size, 100.0 * f.size / total, name.c_str());
+    }
+
+    long long jsSize = fileSize(jsPath);
+    long long dataSize = fileSize(dataPath);
+    bool over = false;
+    auto check = [&](const char* what, double value, double budget, const char* unit, bool kilobytes) {
+        string shown = kilobytes ? kb(value * 1024) : to_string((long long)value) + " " + unit;
+        if (budget < 0) {
+            printf("  %-6s %12s\n", what, shown.c_str());
+            return;
+        }
+        bool bad = value > budget;
+        over = over || bad;
+        printf("  %-6s %12s / %.0f %s  %s\n", what, shown.c_str(), budget, unit, bad ? "EXCEDIDO" : "ok");
+    };
+
+    printf("\nPresupuesto%s:\n", (budgetWasm < 0 && budgetJs < 0 && budgetData < 0 && budgetTti < 0) ? " (sin limites: --budget-*)" : "");
+    check("wasm", (total - nameBytes) / 1024.0, budgetWasm, "KB", true);
+    if (nameBytes > 0) printf("         (no cuenta la seccion name de %s)\n", kb((double)nameBytes).c_str());
+    if (jsSize >= 0) check("js", jsSize / 1024.0, budgetJs, "KB", true);
+    else printf("  js     (no se encontro %s)\n", jsPath.c_str());
+    if (dataSize >= 0) check("data", dataSize / 1024.0, budgetData, "KB", true);
+    else printf("  data   (no se encontro %s)\n", dataPath.c_str());
+    if (tti >= 0) check("tti", tti, budgetTti, "ms", false);
+
+    if (jsSize >= 0 && dataSize >= 0) {
+        printf("  total  %12s\n", kb(total - nameBytes + jsSize + dataSize).c_str());
+    }
+    return over ? 1 : 0;
+}